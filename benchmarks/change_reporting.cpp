@@ -0,0 +1,57 @@
+#include "memprop/memprop.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include <memory>
+using namespace mousebyte::memprop;
+
+namespace {
+    constexpr int owners = 1'000;
+
+    class bench_item
+        : public change_reporting<> {
+    public:
+        public_property<bench_item, int> X {this, 0};
+        public_property<bench_item, int> Y {this, 0};
+        public_property<bench_item, int> Width {this, 0};
+        public_property<bench_item, int> Height {this, 0};
+    };
+    }
+
+
+TEST_CASE("Observe every property of 1k owners", "[benchmark]") {
+    BENCHMARK_ADVANCED("connect to each Changed")(Catch::Benchmark::Chronometer meter) {
+        int count = 0;
+
+        meter.measure([&]
+            {
+            auto items = std::make_unique<bench_item[]>(owners);
+
+            for (int i = 0; i < owners; ++i) {
+                auto& item = items[i];
+
+                item.X.Changed.connect([&count](int const&) { ++count; });
+                item.Y.Changed.connect([&count](int const&) { ++count; });
+                item.Width.Changed.connect([&count](int const&) { ++count; });
+                item.Height.Changed.connect([&count](int const&) { ++count; });
+                item.Width = i;
+                }
+            return count;
+            });
+        };
+    BENCHMARK_ADVANCED("connect to PropertyChanged")(Catch::Benchmark::Chronometer meter) {
+        int count = 0;
+
+        meter.measure([&]
+            {
+            auto items = std::make_unique<bench_item[]>(owners);
+
+            for (int i = 0; i < owners; ++i) {
+                auto& item = items[i];
+
+                item.PropertyChanged.connect([&count](property_id, changed_value) { ++count; });
+                item.Width = i;
+                }
+            return count;
+            });
+        };
+    }
@@ -0,0 +1,69 @@
+#include "memprop/fanout.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include <cmath>
+#include <string>
+using namespace mousebyte::memprop;
+
+namespace {
+    constexpr std::size_t subscriber_count = 20'000;
+
+    class bench_theme {
+    public:
+        public_property<bench_theme, int> Accent {this, 0};
+    };
+
+
+    // stands in for a bound target doing a little work of its own
+    struct subscriber {
+        double value = 0;
+
+        void operator()(
+            int const& v
+            )
+            {
+            for (int i = 0; i < 64; ++i) value += std::sin(v + i);
+            }
+    };
+    }
+
+
+TEST_CASE("Fan out a change to 20k subscribers", "[benchmark]") {
+    std::vector<subscriber> targets(subscriber_count);
+
+    BENCHMARK_ADVANCED("serial Changed slots")(Catch::Benchmark::Chronometer meter) {
+        bench_theme theme;
+
+        for (auto& s : targets) {
+            theme.Accent.Changed.connect([&s](int const& v)
+                {
+                s(v);
+                });
+            }
+        meter.measure([&](int i)
+            {
+            theme.Accent = i;
+            });
+        };
+
+    for (std::size_t threads : {1, 2, 4, 8, 16}) {
+        if (threads > std::max(1u, std::thread::hardware_concurrency())) break;
+        BENCHMARK_ADVANCED("parallel fan-out, " + std::to_string(threads) + " threads")(
+            Catch::Benchmark::Chronometer meter) {
+            bench_theme          theme;
+            fanout_pool          pool(threads - 1);
+            parallel_fanout<int> fanout(theme.Accent, pool);
+
+            for (auto& s : targets) {
+                fanout.connect([&s](int const& v)
+                    {
+                    s(v);
+                    }, dispatch::parallel_safe);
+                }
+            meter.measure([&](int i)
+                {
+                theme.Accent = i;
+                });
+            };
+        }
+    }
@@ -0,0 +1,85 @@
+#include "memprop/frame_diff.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+using namespace mousebyte::memprop;
+
+namespace {
+    constexpr std::size_t element_count = 1'000'000;
+
+    template <typename T>
+    std::vector<T> changed_copy(
+        std::vector<T> const& v,
+        std::size_t           stride
+        )
+        {
+        auto out = v;
+
+        for (std::size_t i = 0; i < out.size(); i += stride) {
+            out[i] = static_cast<T>(out[i] + 1);
+            }
+        return out;
+        }
+    }
+
+
+TEST_CASE("Diff 1M floats", "[benchmark]") {
+    std::vector<float> previous(element_count, 1.0f);
+    auto               sparse = changed_copy(previous, 1000);
+    auto               dense  = changed_copy(previous, 3);
+    changed_bitset     bits;
+
+    BENCHMARK("unchanged") {
+        diff(std::span<float const>(previous), std::span<float const>(previous), bits);
+        return bits.size();
+        };
+    BENCHMARK("0.1% changed") {
+        diff(std::span<float const>(previous), std::span<float const>(sparse), bits);
+        return bits.size();
+        };
+    BENCHMARK("33% changed") {
+        diff(std::span<float const>(previous), std::span<float const>(dense), bits);
+        return bits.size();
+        };
+    BENCHMARK("0.1% changed, scalar kernel") {
+        bits.reset(element_count);
+        detail::diff_kernel<float, 8>(previous.data(), sparse.data(), element_count,
+                                      bits.words().data());
+        return bits.size();
+        };
+    BENCHMARK("0.1% changed, index list") {
+        std::vector<std::uint32_t> indices;
+        diff(std::span<float const>(previous), std::span<float const>(sparse), bits, indices);
+        return indices.size();
+        };
+    }
+
+TEST_CASE("Diff 1M doubles and bytes", "[benchmark]") {
+    std::vector<double>       doubles(element_count, 1.0);
+    auto                      doublesChanged = changed_copy(doubles, 1000);
+    std::vector<std::uint8_t> bytes(element_count, 1);
+    auto                      bytesChanged   = changed_copy(bytes, 1000);
+    changed_bitset            bits;
+
+    BENCHMARK("double, 0.1% changed") {
+        diff(std::span<double const>(doubles), std::span<double const>(doublesChanged), bits);
+        return bits.size();
+        };
+    BENCHMARK("uint8, 0.1% changed") {
+        diff(std::span<std::uint8_t const>(bytes), std::span<std::uint8_t const>(bytesChanged),
+             bits);
+        return bits.size();
+        };
+    }
+
+TEST_CASE("Snapshot capture and diff of 1M floats", "[benchmark]") {
+    std::vector<float>      values(element_count, 1.0f);
+    numeric_snapshot<float> snapshot;
+
+    snapshot.capture(std::span<float const>(values));
+
+    BENCHMARK("capture + diff") {
+        values[element_count / 2] += 1.0f;
+        snapshot.capture(std::span<float const>(values));
+        return snapshot.changed().count();
+        };
+    }
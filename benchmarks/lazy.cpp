@@ -0,0 +1,73 @@
+#include "memprop/lazy.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include <string>
+using namespace mousebyte::memprop;
+
+namespace {
+    constexpr int changes = 10'000;
+
+    class bench_model {
+    public:
+        public_property<bench_model, int> Count {this, 0};
+    };
+
+
+    class bench_label {
+    public:
+        public_property<bench_label, std::string> Eager {this};
+        lazy_property<bench_label, std::string> Lazy {this};
+    };
+
+
+    std::string format_count(
+        int const& c
+        )
+        {
+        std::string s = "Showing ";
+
+        s += std::to_string(c);
+        s += " of ";
+        s += std::to_string(changes);
+        s += " items";
+        return s;
+        }
+    }
+
+
+TEST_CASE("Change a bound source 10k times, reading the target every nth change", "[benchmark]") {
+    for (int every : {1, 16, 256}) {
+        BENCHMARK_ADVANCED("eager binding, read every " + std::to_string(every))(
+            Catch::Benchmark::Chronometer meter) {
+            bench_model m;
+            bench_label l;
+            auto        binding = l.Eager.bind(m.Count, &format_count);
+            std::size_t size    = 0;
+
+            meter.measure([&]
+                {
+                for (int i = 0; i < changes; ++i) {
+                    m.Count = i;
+                    if (i % every == 0) size += static_cast<std::string const&>(l.Eager).size();
+                    }
+                return size;
+                });
+            };
+        BENCHMARK_ADVANCED("lazy binding, read every " + std::to_string(every))(
+            Catch::Benchmark::Chronometer meter) {
+            bench_model m;
+            bench_label l;
+            auto        binding = l.Lazy.bind(m.Count, &format_count);
+            std::size_t size    = 0;
+
+            meter.measure([&]
+                {
+                for (int i = 0; i < changes; ++i) {
+                    m.Count = i;
+                    if (i % every == 0) size += static_cast<std::string const&>(l.Lazy).size();
+                    }
+                return size;
+                });
+            };
+        }
+    }
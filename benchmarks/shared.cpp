@@ -0,0 +1,99 @@
+#include "memprop/shared.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace mousebyte::memprop;
+
+namespace {
+    struct ping {
+        int tick;
+    };
+
+
+    struct pong {
+        int tick;
+    };
+
+
+    class bench_engine {
+    public:
+        public_property<bench_engine, int> Tick {this, 0};
+    };
+
+
+    class bench_view {
+    public:
+        shared_subscriber<ping> Source;
+        shared_property<bench_view, &ping::tick> Tick {this, Source};
+
+        explicit bench_view(
+            std::string const& name
+            )
+            : Source(name, 1)
+            {
+            }
+    };
+
+
+    template <typename Layout>
+    void open_when_published(
+        shared_subscriber<Layout>& subscriber
+        )
+        {
+        while (subscriber.open() != shared_status::connected) ::usleep(100);
+        }
+
+
+    // echoes each tick it sees on the ping segment back on the pong segment
+    [[noreturn]] void run_echo(
+        std::string const& pingName,
+        std::string const& pongName
+        )
+        {
+        shared_publisher<pong> echo(pongName, 1);
+        bench_view             view(pingName);
+        bool                   done = false;
+
+        open_when_published(view.Source);
+        view.Tick.Changed.connect([&](int const& tick)
+            {
+            echo.write<&pong::tick>(tick);
+            done = tick < 0;
+            });
+        while (!done) view.Source.wait(std::chrono::seconds(1));
+        ::_exit(0);
+        }
+    }
+
+
+TEST_CASE("Round trip a property change between two processes", "[benchmark]") {
+    auto pingName = "/memprop_bench_ping_" + std::to_string(::getpid());
+    auto pongName = "/memprop_bench_pong_" + std::to_string(::getpid());
+
+    bench_engine           engine;
+    shared_publisher<ping> publisher(pingName, 1);
+
+    publisher.publish<&ping::tick>(engine.Tick);
+    auto child = ::fork();
+
+    if (child == 0) run_echo(pingName, pongName);
+    shared_subscriber<pong> replies(pongName, 1);
+
+    open_when_published(replies);
+    int tick = 0;
+
+    BENCHMARK_ADVANCED("publish, wake the other process, and wait for its echo")(
+        Catch::Benchmark::Chronometer meter) {
+        meter.measure([&]
+            {
+            engine.Tick = ++tick;
+            while (replies.data().tick != tick) replies.wait(std::chrono::seconds(1));
+            return tick;
+            });
+        };
+
+    engine.Tick = -1;
+    ::waitpid(child, nullptr, 0);
+    }
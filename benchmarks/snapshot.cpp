@@ -0,0 +1,88 @@
+#include "memprop/snapshot.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include <memory>
+using namespace mousebyte::memprop;
+
+namespace {
+    constexpr std::size_t owner_count = 100'000;
+
+    class bench_widget {
+    public:
+        public_property<bench_widget, float> Opacity {this, 1.0f};
+        public_property<bench_widget, int> Width {this, 100};
+        public_property<bench_widget, int> Height {this, 50};
+        public_property<bench_widget, bool> Visible {this, true};
+
+        using properties = property_list<bench_widget,
+                                         property_entry<"Opacity", &bench_widget::Opacity>,
+                                         property_entry<"Width", &bench_widget::Width>,
+                                         property_entry<"Height", &bench_widget::Height>,
+                                         property_entry<"Visible", &bench_widget::Visible>>;
+    };
+
+
+    class bench_label {
+    public:
+        public_property<bench_label, int> Width {this, 100};
+        public_property<bench_label, std::string> Text {this, "label text"};
+
+        using properties = property_list<bench_label,
+                                         property_entry<"Width", &bench_label::Width>,
+                                         property_entry<"Text", &bench_label::Text>>;
+    };
+
+
+    template <typename Owner>
+    std::vector<std::unique_ptr<Owner>> make_owners()
+        {
+        std::vector<std::unique_ptr<Owner>> owners;
+
+        owners.reserve(owner_count);
+        for (std::size_t i = 0; i < owner_count; ++i) {
+            owners.push_back(std::make_unique<Owner>());
+            }
+        return owners;
+        }
+    }
+
+
+TEST_CASE("Snapshot 100k owners of trivially copyable properties", "[benchmark]") {
+    auto                   owners = make_owners<bench_widget>();
+    std::vector<std::byte> data;
+
+    save_snapshot(owners, data);
+
+    BENCHMARK("save") {
+        std::vector<std::byte> out;
+        out.reserve(data.size());
+        save_snapshot(owners, out);
+        return out.size();
+        };
+    BENCHMARK("restore, coalesced notifications") {
+        return restore_snapshot(owners, data);
+        };
+    BENCHMARK("restore, no notifications") {
+        return restore_snapshot(owners, data, restore_notify::none);
+        };
+    BENCHMARK("restore, notification per property") {
+        return restore_snapshot(owners, data, restore_notify::each);
+        };
+    }
+
+TEST_CASE("Snapshot 100k owners with string properties", "[benchmark]") {
+    auto                   owners = make_owners<bench_label>();
+    std::vector<std::byte> data;
+
+    save_snapshot(owners, data);
+
+    BENCHMARK("save") {
+        std::vector<std::byte> out;
+        out.reserve(data.size());
+        save_snapshot(owners, out);
+        return out.size();
+        };
+    BENCHMARK("restore, coalesced notifications") {
+        return restore_snapshot(owners, data);
+        };
+    }
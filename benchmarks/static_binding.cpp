@@ -0,0 +1,61 @@
+#include "memprop/static_binding.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+using namespace mousebyte::memprop;
+
+namespace {
+    constexpr int changes = 10'000;
+
+    struct scale_converter {
+        int operator()(
+            int const& h
+            ) const
+            {
+            return h * 2;
+            }
+    };
+
+
+    class runtime_frame {
+    public:
+        public_property<runtime_frame, int> Height {this, 0};
+        public_property<runtime_frame, int> Width {this, 0};
+
+        runtime_frame()
+            {
+            Width.bind(Height, scale_converter {});
+            }
+    };
+
+
+    class static_frame {
+    public:
+        public_property<static_frame, int> Height {this, 0};
+        public_property<static_frame, int> Width {this, 0};
+
+        using static_bindings = static_binding_list<
+            static_binding<&static_frame::Width, scale_converter {}, &static_frame::Height>>;
+    };
+    }
+
+
+TEST_CASE("Propagate 10k changes within an owner", "[benchmark]") {
+    BENCHMARK_ADVANCED("runtime binding")(Catch::Benchmark::Chronometer meter) {
+        runtime_frame f;
+
+        meter.measure([&]
+            {
+            for (int i = 0; i < changes; ++i) f.Height = i;
+            return static_cast<int>(f.Width);
+            });
+        };
+    BENCHMARK_ADVANCED("static binding")(Catch::Benchmark::Chronometer meter) {
+        static_frame f;
+
+        meter.measure([&]
+            {
+            for (int i = 0; i < changes; ++i) f.Height = i;
+            return static_cast<int>(f.Width);
+            });
+        };
+    }
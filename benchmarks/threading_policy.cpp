@@ -0,0 +1,73 @@
+#include "memprop/memprop.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include <string>
+using namespace mousebyte::memprop;
+
+namespace {
+    constexpr int emissions = 10'000;
+
+    template <typename Policy>
+    class bench_label {
+    public:
+        public_property<bench_label, int, nullptr, Policy> Width {this, 0};
+    };
+
+
+    template <typename Policy>
+    void benchmark_emission(
+        std::string const& name,
+        int                slots
+        )
+        {
+        BENCHMARK_ADVANCED(name + ", " + std::to_string(slots) + " slots")(
+            Catch::Benchmark::Chronometer meter) {
+            bench_label<Policy> label;
+            int                 sum = 0;
+
+            for (int i = 0; i < slots; ++i) {
+                label.Width.Changed.connect([&sum](int const& v)
+                    {
+                    sum += v;
+                    });
+                }
+            meter.measure([&]
+                {
+                for (int i = 0; i < emissions; ++i) label.Width = i;
+                return sum;
+                });
+            };
+        }
+
+
+    template <typename Policy>
+    void benchmark_connection(
+        std::string const& name
+        )
+        {
+        BENCHMARK_ADVANCED(name + ", connect and disconnect")(Catch::Benchmark::Chronometer meter) {
+            bench_label<Policy> label;
+
+            meter.measure([&]
+                {
+                for (int i = 0; i < emissions; ++i) {
+                    auto c = label.Width.Changed.connect([](int const&) {});
+                    c.disconnect();
+                    }
+                });
+            };
+        }
+    }
+
+
+TEST_CASE("Emit Changed 10k times under each threading policy", "[benchmark]") {
+    for (int slots : {0, 1, 8}) {
+        benchmark_emission<thread_safe>("thread_safe", slots);
+        benchmark_emission<single_threaded>("single_threaded", slots);
+        }
+    }
+
+TEST_CASE("Connect and disconnect 10k slots under each threading policy", "[benchmark]") {
+    benchmark_connection<thread_safe>("thread_safe");
+    benchmark_connection<single_threaded>("single_threaded");
+    }
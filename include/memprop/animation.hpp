@@ -0,0 +1,309 @@
+/*
+ * Animated numeric properties. Animations are kept in one contiguous array
+ * and advanced together by a ticker, which sets every animated value
+ * before emitting any of their Changed signals.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_ANIMATION_HPP
+#define MB_MEMPROP_ANIMATION_HPP
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief Maps the linear progress of an animation, from 0 to 1, to
+         * the progress of its value.
+         */
+        using easing = double (*)(double);
+
+        /**
+         * @brief Common easing functions.
+         */
+        namespace ease {
+            inline double linear(
+                double t
+                )
+                {
+                return t;
+                }
+
+            inline double in_quad(
+                double t
+                )
+                {
+                return t * t;
+                }
+
+            inline double out_quad(
+                double t
+                )
+                {
+                return t * (2 - t);
+                }
+
+            inline double in_out_quad(
+                double t
+                )
+                {
+                return t < 0.5 ? 2 * t * t : -1 + (4 - 2 * t) * t;
+                }
+
+            inline double in_out_cubic(
+                double t
+                )
+                {
+                return t < 0.5 ? 4 * t * t * t : 1 - std::pow(-2 * t + 2, 3) / 2;
+                }
+            }
+
+
+        namespace detail {
+            template <typename P>
+            concept AnimatableProperty = std::is_arithmetic_v<traits::value_type<P>>
+                                         && !std::same_as<traits::value_type<P>, bool>;
+            }
+
+
+        /**
+         * @brief Advances the animations of numeric properties. Each call to
+         * tick() interpolates every active animation in one pass, setting the
+         * values without notification, and then emits Changed once for each
+         * property that was updated, so that observers see a consistent frame.
+         *
+         * Animated properties must outlive their animations, or be cancelled
+         * before they are destroyed.
+         */
+        class ticker {
+        public:
+            using clock_type = std::chrono::steady_clock;
+            using time_point = clock_type::time_point;
+            using duration   = clock_type::duration;
+
+        private:
+            struct animation {
+                void* prop;
+                bool (* apply)(void*, double);
+                void (* notify)(void*);
+                easing ease;
+                double from;
+                double to;
+                time_point start;
+                double length;
+                bool updated;
+                bool finished;
+                bool canceled;
+            };
+
+
+            template <typename P>
+            struct animation_ops {
+                using value_type = detail::traits::value_type<P>;
+
+                static bool apply(
+                    void*  prop,
+                    double v
+                    )
+                    {
+                    auto&      p = *static_cast<detail::settable_prop<P>*>(prop);
+                    value_type value;
+
+                    if constexpr (std::is_integral_v<value_type>) {
+                        // most frames of a slow integer animation round to
+                        // the value already set
+                        value = static_cast<value_type>(std::llround(v));
+                        if (value == detail::property_access::get(p)) return false;
+                        } else {
+                        value = static_cast<value_type>(v);
+                        }
+                    return detail::property_access::set_silent(p, value);
+                    }
+
+                static void notify(
+                    void* prop
+                    )
+                    {
+                    detail::property_access::notify(*static_cast<detail::settable_prop<P>*>(prop));
+                    }
+            };
+
+
+            std::function<time_point()> _clock;
+            std::vector<animation> _animations;
+            std::unordered_map<void const*, std::size_t> _index;
+            bool _notifying = false;
+
+            // Removes finished and canceled animations, once no notification
+            // loop depends on their indices.
+            void compact()
+                {
+                std::erase_if(_animations, [](animation const& a)
+                    {
+                    return a.finished || a.canceled;
+                    });
+                _index.clear();
+                for (std::size_t i = 0; i < _animations.size(); ++i) {
+                    _index.emplace(_animations[i].prop, i);
+                    }
+                }
+
+            void remove_at(
+                std::size_t i
+                )
+                {
+                _index.erase(_animations[i].prop);
+                if (i + 1 != _animations.size()) {
+                    _animations[i] = _animations.back();
+                    _index[_animations[i].prop] = i;
+                    }
+                _animations.pop_back();
+                }
+
+        public:
+            /**
+             * @brief Creates a ticker that reads the time from the given clock.
+             */
+            explicit ticker(
+                std::function<time_point()> clock = &clock_type::now
+                )
+                : _clock(std::move(clock))
+                {
+                }
+
+            /**
+             * @brief Gets the number of active animations.
+             */
+            std::size_t size() const
+                {
+                return _animations.size();
+                }
+
+            /**
+             * @brief Animates a property from its current value to the given
+             * value, replacing any animation of the property already active.
+             *
+             * @param prop The property to animate.
+             * @param to The final value.
+             * @param length The length of the animation.
+             * @param ease The easing function.
+             */
+            template <detail::AnimatableProperty P>
+            void animate(
+                public_property_base<P>&           prop,
+                detail::traits::const_reference<P> to,
+                duration                           length,
+                easing                             ease = &ease::linear
+                )
+                {
+                using ops = animation_ops<P>;
+
+                auto&     base = static_cast<detail::settable_prop<P>&>(prop);
+                animation a    {
+                    &base, &ops::apply, &ops::notify, ease,
+                    static_cast<double>(detail::property_access::get(base)),
+                    static_cast<double>(to), _clock(),
+                    std::chrono::duration<double>(length).count(), false, false, false
+                    };
+
+                if (auto it = _index.find(&base); it != _index.end()) {
+                    // a frame applied but not yet notified is still notified
+                    a.updated               = _animations[it->second].updated;
+                    _animations[it->second] = a;
+                    } else {
+                    _index.emplace(&base, _animations.size());
+                    _animations.push_back(a);
+                    }
+                }
+
+            /**
+             * @brief Stops the animation of a property, leaving its current value.
+             *
+             * @return False if the property was not being animated.
+             */
+            template <typename P>
+            bool cancel(
+                public_property_base<P>& prop
+                )
+                {
+                auto it = _index.find(static_cast<detail::settable_prop<P>*>(&prop));
+
+                if (it == _index.end()) return false;
+                if (_notifying) {
+                    _animations[it->second].canceled = true;
+                    _index.erase(it);
+                    } else {
+                    remove_at(it->second);
+                    }
+                return true;
+                }
+
+            /**
+             * @brief Checks whether a property is being animated.
+             */
+            template <typename P>
+            bool animating(
+                public_property_base<P> const& prop
+                ) const
+                {
+                return _index.contains(static_cast<detail::settable_prop<P> const*>(&prop));
+                }
+
+            /**
+             * @brief Advances every animation to the current time of the clock.
+             */
+            void tick()
+                {
+                tick(_clock());
+                }
+
+            /**
+             * @brief Advances every animation to the given time. Finished
+             * animations are set to their final value and removed.
+             */
+            void tick(
+                time_point now
+                )
+                {
+                for (auto& a : _animations) {
+                    auto elapsed = std::chrono::duration<double>(now - a.start).count();
+                    auto t       = a.length > 0 ? std::clamp(elapsed / a.length, 0.0, 1.0) : 1.0;
+
+                    a.updated  = a.apply(a.prop, a.from + (a.to - a.from) * a.ease(t));
+                    a.finished = t >= 1;
+                    }
+
+                // Slots may start or cancel animations. Started ones are
+                // appended and not visited, and canceled ones are only marked,
+                // so no animation moves until the loop is done.
+                struct notification {
+                    ticker& t;
+
+                    ~notification()
+                        {
+                        t._notifying = false;
+                        t.compact();
+                        }
+                } guard {*this};
+
+                auto count = _animations.size();
+
+                _notifying = true;
+                for (std::size_t i = 0; i < count; ++i) {
+                    if (!_animations[i].updated) continue;
+                    auto prop = _animations[i].prop;
+                    auto fn   = _animations[i].notify;
+
+                    _animations[i].updated = false;
+                    fn(prop);
+                    }
+                }
+        };
+        }
+    }
+#endif
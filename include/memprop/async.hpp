@@ -0,0 +1,368 @@
+/*
+ * Computed properties evaluated asynchronously. Getters run on a pool of
+ * worker threads, and results are applied on the owner's thread when it
+ * polls its async_context.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_ASYNC_HPP
+#define MB_MEMPROP_ASYNC_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief A fixed set of worker threads that run submitted jobs in order
+         * of submission.
+         */
+        class worker_pool {
+            std::vector<std::thread> _threads;
+            std::deque<std::function<void()>> _jobs;
+            std::mutex _mutex;
+            std::condition_variable _wake;
+            bool _stopping = false;
+
+            void work()
+                {
+                for (;;) {
+                    std::function<void()> job;
+                    {
+                    std::unique_lock lock(_mutex);
+
+                    _wake.wait(lock, [this]
+                        {
+                        return _stopping || !_jobs.empty();
+                        });
+                    if (_stopping) return;
+                    job = std::move(_jobs.front());
+                    _jobs.pop_front();
+                    }
+                    job();
+                    }
+                }
+
+        public:
+            /**
+             * @brief Starts the given number of worker threads.
+             */
+            explicit worker_pool(
+                std::size_t threads = std::max(1u, std::thread::hardware_concurrency())
+                )
+                {
+                _threads.reserve(threads);
+                for (std::size_t i = 0; i < threads; ++i) {
+                    _threads.emplace_back([this]
+                        {
+                        work();
+                        });
+                    }
+                }
+
+            worker_pool(worker_pool const&)            = delete;
+            worker_pool& operator=(worker_pool const&) = delete;
+
+            /**
+             * @brief Stops the workers. Jobs that have not started are discarded,
+             * and running jobs are waited for.
+             */
+            ~worker_pool()
+                {
+                {
+                std::lock_guard lock(_mutex);
+                _stopping = true;
+                }
+                _wake.notify_all();
+                for (auto& t : _threads) t.join();
+                }
+
+            /**
+             * @brief Gets the number of worker threads.
+             */
+            std::size_t size() const
+                {
+                return _threads.size();
+                }
+
+            /**
+             * @brief Queues a job to run on a worker thread.
+             */
+            void submit(
+                std::function<void()> job
+                )
+                {
+                {
+                std::lock_guard lock(_mutex);
+                _jobs.push_back(std::move(job));
+                }
+                _wake.notify_one();
+                }
+        };
+
+
+        /**
+         * @brief Connects asynchronous properties to a worker pool and to the
+         * thread that owns them. Results computed on the workers are queued,
+         * and applied when the owner's thread calls poll().
+         */
+        class async_context {
+            std::vector<std::function<void()>> _completions;
+            std::vector<std::function<void()>> _running;
+            std::mutex _mutex;
+            // declared last, so the workers are joined before the queue
+            // that running jobs post to is destroyed
+            worker_pool _pool;
+
+        public:
+            /**
+             * @brief Creates a context with the given number of worker threads.
+             */
+            explicit async_context(
+                std::size_t threads = std::max(1u, std::thread::hardware_concurrency())
+                )
+                : _pool(threads)
+                {
+                }
+
+            /**
+             * @brief Gets the worker pool.
+             */
+            worker_pool& pool()
+                {
+                return _pool;
+                }
+
+            /**
+             * @brief Queues a function to run on the owner's thread. Safe to call
+             * from any thread.
+             */
+            void post(
+                std::function<void()> fn
+                )
+                {
+                std::lock_guard lock(_mutex);
+                _completions.push_back(std::move(fn));
+                }
+
+            /**
+             * @brief Runs the functions queued so far. Must be called from the
+             * owner's thread.
+             *
+             * @return The number of functions run.
+             */
+            std::size_t poll()
+                {
+                {
+                std::lock_guard lock(_mutex);
+                _running.swap(_completions);
+                }
+                auto count = _running.size();
+
+                for (auto& fn : _running) fn();
+                _running.clear();
+                return count;
+                }
+        };
+
+
+        namespace detail {
+            /**
+             * @brief A const member function of Owner that either computes a
+             * value, or returns a function object that computes it.
+             */
+            template <typename Getter, typename Owner, typename V>
+            concept AsyncGetter = requires(Owner const& o, Getter g) {
+                    { (o.*g)() }->std::convertible_to<V>;
+                } || requires(Owner const& o, Getter g) {
+                    { (o.*g)()() }->std::convertible_to<V>;
+                };
+            }
+
+        template <typename Owner, typename V, detail::AsyncGetter<Owner, V> auto Get>
+        class async_computed_property;
+
+        namespace detail {
+            template <typename Owner, typename V, detail::AsyncGetter<Owner, V> auto Get>
+            struct property_traits<async_computed_property<Owner, V, Get>> {
+                using owner_type      = Owner;
+                using property_type   = async_computed_property<Owner, V, Get>;
+                using value_type      = std::remove_cvref_t<V>;
+                using const_reference = value_type const&;
+            };
+            }
+
+
+        /**
+         * @brief Exposes a property whose value is computed on a worker thread
+         * whenever it is invalidated. Until the computation completes, the
+         * property holds its last completed value. Results are applied, and
+         * Changed is emitted, on the owner's thread when the context is polled.
+         * A computation that is superseded by a later invalidation is skipped
+         * if it has not started, and its result is discarded otherwise.
+         *
+         * If the getter returns a function object, the getter is called on the
+         * owner's thread when the property is invalidated, and only the returned
+         * function runs on a worker. This lets the getter capture its inputs by
+         * value. Otherwise the getter itself runs concurrently with the owner's
+         * thread, and must only read state that is not modified while a
+         * computation is pending. The property should then be declared after
+         * the members the getter reads, so that it is destroyed, and waits for
+         * the getter, before they are.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam V The value type.
+         * @tparam Get A pointer to the const member function of Owner that
+         * computes the value, or returns a function object that computes it.
+         */
+        template <typename Owner, typename V, detail::AsyncGetter<Owner, V> auto Get>
+        class async_computed_property
+            : public readonly_property_base<async_computed_property<Owner, V, Get>> {
+            using my_type = async_computed_property<Owner, V, Get>;
+
+            // Shared with the jobs in flight, which may outlive the property.
+            struct state {
+                std::mutex computing;
+                std::atomic<std::uint64_t> generation = 0;
+                my_type* property;
+            };
+
+
+            friend Owner;
+        public:
+            using value_type      = detail::traits::value_type<my_type>;
+            using const_reference = detail::traits::const_reference<my_type>;
+            async_computed_property(
+                Owner*         owner,
+                async_context& context
+                )
+                : readonly_property_base<my_type>(owner)
+                , _context(&context)
+                , _state(std::make_shared<state>())
+                {
+                _state->property = this;
+                }
+
+            async_computed_property(
+                Owner*          owner,
+                async_context&  context,
+                const_reference v
+                )
+                : async_computed_property(owner, context)
+                {
+                _value = v;
+                }
+
+            /**
+             * @brief Cancels any pending computation. Waits for a running
+             * getter to return.
+             */
+            ~async_computed_property()
+                {
+                std::lock_guard lock(_state->computing);
+                ++_state->generation;
+                _state->property = nullptr;
+                }
+
+            /**
+             * @brief Schedules the value to be recomputed, superseding any
+             * pending computation.
+             */
+            void invalidate()
+                {
+                auto gen   = ++_state->generation;
+                auto owner = this->owner();
+
+                if constexpr (std::invocable<decltype((owner->*Get)())>) {
+                    schedule(gen, (owner->*Get)());
+                    } else {
+                    schedule(gen, [owner]
+                        {
+                        return (owner->*Get)();
+                        });
+                    }
+                }
+
+            /**
+             * @brief Checks whether the value is being recomputed.
+             */
+            bool pending() const
+                {
+                return _completed != _state->generation;
+                }
+
+            /**
+             * @brief Gets the exception thrown by the last completed
+             * computation, or null if it succeeded. A failed computation
+             * leaves the value unchanged and does not emit Changed.
+             */
+            std::exception_ptr error() const
+                {
+                return _error;
+                }
+
+        protected:
+            const_reference get() const override
+                {
+                return _value;
+                }
+
+        private:
+            template <typename Fn>
+            void schedule(
+                std::uint64_t gen,
+                Fn            compute
+                )
+                {
+                _context->pool().submit(
+                    [s = _state, gen, context = _context, compute = std::move(compute)]() mutable
+                    {
+                    std::unique_lock lock(s->computing);
+
+                    if (s->generation != gen) return;
+                    std::optional<value_type> v;
+                    std::exception_ptr        error;
+
+                    try {
+                        v = compute();
+                        } catch (...) {
+                        error = std::current_exception();
+                        }
+
+                    lock.unlock();
+                    context->post([s, gen, v = std::move(v), error]
+                        {
+                        if (s->generation != gen || !s->property) return;
+                        s->property->_completed = gen;
+                        s->property->_error     = error;
+                        if (v) s->property->set(*v);
+                        });
+                    });
+                }
+
+            bool do_set(
+                const_reference v
+                ) override
+                {
+                _value = v;
+                return true;
+                }
+
+            async_context* _context;
+            std::shared_ptr<state> _state;
+            std::uint64_t _completed = 0;
+            std::exception_ptr _error;
+            value_type _value {};
+        };
+        }
+    }
+#endif
@@ -0,0 +1,364 @@
+/*
+ * Coroutine support for property changes. The next change of a property
+ * can be awaited, and a stream of changes can be awaited repeatedly.
+ * Waiters are stored in the coroutine frame and linked into the property,
+ * so awaiting needs no allocation and no slot connection.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_CORO_HPP
+#define MB_MEMPROP_CORO_HPP
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        namespace detail {
+            /**
+             * @brief An intrusive queue node for a coroutine waiting to be
+             * resumed by an executor.
+             */
+            struct scheduled {
+                scheduled* next = nullptr;
+                std::coroutine_handle<> handle;
+                bool queued = false;
+            };
+            }
+
+
+        /**
+         * @brief Resumes coroutines that were woken by a property change. Without
+         * an executor, a waiting coroutine is resumed from within the setter
+         * that changed the property.
+         */
+        class executor {
+        public:
+            virtual ~executor() = default;
+
+            /**
+             * @brief Queues a node to be resumed later.
+             */
+            virtual void post(detail::scheduled& node) = 0;
+
+            /**
+             * @brief Removes a queued node that must no longer be resumed.
+             */
+            virtual void cancel(detail::scheduled& node) = 0;
+        };
+
+
+        /**
+         * @brief A single-threaded executor that resumes queued coroutines when
+         * run() is called, in the order they were woken.
+         */
+        class manual_executor
+            : public executor {
+            detail::scheduled* _head = nullptr;
+            detail::scheduled* _tail = nullptr;
+
+        public:
+            void post(
+                detail::scheduled& node
+                ) override
+                {
+                node.next   = nullptr;
+                node.queued = true;
+                if (_tail) _tail->next = &node;
+                else _head = &node;
+                _tail = &node;
+                }
+
+            void cancel(
+                detail::scheduled& node
+                ) override
+                {
+                detail::scheduled* prev = nullptr;
+
+                for (auto n = _head; n; prev = n, n = n->next) {
+                    if (n != &node) continue;
+                    if (prev) prev->next = n->next;
+                    else _head = n->next;
+                    if (_tail == n) _tail = prev;
+                    break;
+                    }
+                node.queued = false;
+                }
+
+            /**
+             * @brief Checks whether any coroutine is waiting to be resumed.
+             */
+            bool empty() const
+                {
+                return !_head;
+                }
+
+            /**
+             * @brief Resumes the first queued coroutine.
+             *
+             * @return False if the queue was empty.
+             */
+            bool run_one()
+                {
+                if (!_head) return false;
+                auto node = _head;
+
+                _head = node->next;
+                if (!_head) _tail = nullptr;
+                node->queued = false;
+                node->handle.resume();
+                return true;
+                }
+
+            /**
+             * @brief Resumes queued coroutines until the queue is empty,
+             * including those woken while running.
+             *
+             * @return The number of coroutines resumed.
+             */
+            std::size_t run()
+                {
+                std::size_t count = 0;
+
+                while (run_one()) ++count;
+                return count;
+                }
+        };
+
+
+        /**
+         * @brief A coroutine that starts eagerly and is destroyed with its task
+         * object. Exceptions propagate to whoever resumed the coroutine.
+         */
+        class task {
+        public:
+            struct promise_type {
+                task get_return_object()
+                    {
+                    return task(std::coroutine_handle<promise_type>::from_promise(*this));
+                    }
+
+                std::suspend_never initial_suspend() noexcept
+                    {
+                    return {};
+                    }
+
+                std::suspend_always final_suspend() noexcept
+                    {
+                    return {};
+                    }
+
+                void return_void()
+                    {
+                    }
+
+                void unhandled_exception()
+                    {
+                    throw;
+                    }
+            };
+
+
+            task(task&& other) noexcept
+                : _handle(std::exchange(other._handle, {}))
+                {
+                }
+
+            task& operator=(
+                task&& other
+                ) noexcept
+                {
+                if (this != &other) {
+                    if (_handle) _handle.destroy();
+                    _handle = std::exchange(other._handle, {});
+                    }
+                return *this;
+                }
+
+            ~task()
+                {
+                if (_handle) _handle.destroy();
+                }
+
+            /**
+             * @brief Checks whether the coroutine has finished.
+             */
+            bool done() const
+                {
+                return !_handle || _handle.done();
+                }
+
+        private:
+            explicit task(
+                std::coroutine_handle<promise_type> handle
+                )
+                : _handle(handle)
+                {
+                }
+
+            std::coroutine_handle<promise_type> _handle;
+        };
+
+
+        namespace detail {
+            /**
+             * @brief Awaits the next change of a property, and completes with
+             * the new value. Returned by next_change().
+             */
+            template <typename Prop>
+            class change_awaiter
+                : change_waiter, scheduled {
+                using value_type = traits::value_type<Prop>;
+
+                friend class settable_prop<Prop>;
+
+                executor* _executor = nullptr;
+                std::optional<value_type> _value;
+
+                change_awaiter(
+                    settable_prop<Prop>& prop,
+                    executor*            e
+                    )
+                    : _executor(e)
+                    {
+                    notify = &on_change;
+                    source = &prop;
+                    }
+
+                static void on_change(
+                    change_waiter* w,
+                    void const*    v
+                    )
+                    {
+                    auto self = static_cast<change_awaiter*>(w);
+
+                    self->_value.emplace(*static_cast<value_type const*>(v));
+                    if (self->_executor) self->_executor->post(*self);
+                    else self->handle.resume();
+                    }
+
+            public:
+                change_awaiter(change_awaiter const&)            = delete;
+                change_awaiter& operator=(change_awaiter const&) = delete;
+
+                ~change_awaiter()
+                    {
+                    unlink_waiter(*this);
+                    if (queued) _executor->cancel(*this);
+                    }
+
+                bool await_ready() const noexcept
+                    {
+                    return false;
+                    }
+
+                void await_suspend(
+                    std::coroutine_handle<> h
+                    )
+                    {
+                    handle = h;
+                    link_waiter(property_access::waiters(*static_cast<settable_prop<Prop>*>(source)),
+                                *this);
+                    }
+
+                value_type await_resume()
+                    {
+                    return std::move(*_value);
+                    }
+            };
+
+
+            /**
+             * @brief Receives every change of a property for as long as it
+             * exists. Changes made while the consumer is not awaiting are
+             * coalesced, so next() completes with the latest value. Returned by
+             * changes().
+             */
+            template <typename Prop>
+            class change_stream
+                : change_waiter, scheduled {
+                using value_type = traits::value_type<Prop>;
+
+                friend class settable_prop<Prop>;
+
+                executor* _executor = nullptr;
+                std::optional<value_type> _latest;
+                bool _waiting = false;
+
+                change_stream(
+                    settable_prop<Prop>& prop,
+                    executor*            e
+                    )
+                    : _executor(e)
+                    {
+                    notify = &on_change;
+                    source = &prop;
+                    link_waiter(property_access::waiters(prop), *this);
+                    }
+
+                static void on_change(
+                    change_waiter* w,
+                    void const*    v
+                    )
+                    {
+                    auto self = static_cast<change_stream*>(w);
+
+                    self->_latest = *static_cast<value_type const*>(v);
+                    link_waiter(property_access::waiters(*static_cast<settable_prop<Prop>*>(self->source)),
+                                *self);
+
+                    if (!std::exchange(self->_waiting, false)) return;
+                    if (self->_executor) self->_executor->post(*self);
+                    else self->handle.resume();
+                    }
+
+                struct next_awaiter {
+                    change_stream* stream;
+
+                    bool await_ready() const noexcept
+                        {
+                        return stream->_latest.has_value();
+                        }
+
+                    void await_suspend(
+                        std::coroutine_handle<> h
+                        )
+                        {
+                        stream->handle   = h;
+                        stream->_waiting = true;
+                        }
+
+                    value_type await_resume()
+                        {
+                        value_type v = std::move(*stream->_latest);
+
+                        stream->_latest.reset();
+                        return v;
+                        }
+                };
+
+            public:
+                change_stream(change_stream const&)            = delete;
+                change_stream& operator=(change_stream const&) = delete;
+
+                ~change_stream()
+                    {
+                    unlink_waiter(*this);
+                    if (queued) _executor->cancel(*this);
+                    }
+
+                /**
+                 * @brief Gets an awaitable that completes with the latest value
+                 * not yet received, waiting for a change if there is none.
+                 */
+                next_awaiter next()
+                    {
+                    return {this};
+                    }
+            };
+            }
+        }
+    }
+#endif
@@ -0,0 +1,355 @@
+/*
+ * Parallel fan-out of property changes to many independent subscribers.
+ * Subscribers that declare themselves parallel-safe are partitioned across
+ * a work-stealing pool once there are enough of them, and the setter
+ * returns only after every subscriber has run.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_FANOUT_HPP
+#define MB_MEMPROP_FANOUT_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief A pool of threads that runs parallel loops. The range of a
+         * loop is split into chunks, which are dealt out evenly to the workers
+         * and the calling thread; a thread that runs out of chunks steals the
+         * remaining chunks of the others.
+         */
+        class fanout_pool {
+            struct alignas(64) lane {
+                std::atomic<std::size_t> next {0};
+                std::size_t end = 0;
+            };
+
+
+            std::vector<std::thread> _threads;
+            std::unique_ptr<lane[]> _lanes;
+            std::mutex _dispatch;
+            std::atomic<std::uint64_t> _epoch {0};
+            std::atomic<std::size_t> _pending {0};
+            std::atomic<bool> _stopping {false};
+
+            // the loop being run
+            void (* _run)(void*, std::size_t, std::size_t) = nullptr;
+            void* _context = nullptr;
+            std::size_t _count = 0;
+            std::size_t _grain = 1;
+            std::exception_ptr _error;
+            std::mutex _errorMutex;
+
+            static inline thread_local fanout_pool* _current = nullptr;
+
+            std::size_t lane_count() const
+                {
+                return _threads.size() + 1;
+                }
+
+            void work(
+                std::size_t self
+                )
+                {
+                auto lanes = lane_count();
+
+                for (std::size_t i = 0; i < lanes; ++i) {
+                    auto& l = _lanes[(self + i) % lanes];
+
+                    for (;;) {
+                        auto chunk = l.next.fetch_add(1, std::memory_order_relaxed);
+
+                        if (chunk >= l.end) break;
+                        auto begin = chunk * _grain;
+
+                        try {
+                            _run(_context, begin, std::min(begin + _grain, _count));
+                            } catch (...) {
+                            std::lock_guard lock(_errorMutex);
+                            if (!_error) _error = std::current_exception();
+                            }
+                        }
+                    }
+                }
+
+            void worker(
+                std::size_t self
+                )
+                {
+                _current = this;
+                std::uint64_t seen = 0;
+
+                for (;;) {
+                    _epoch.wait(seen, std::memory_order_acquire);
+                    seen = _epoch.load(std::memory_order_acquire);
+                    if (_stopping.load(std::memory_order_relaxed)) return;
+                    work(self);
+                    if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) _pending.notify_one();
+                    }
+                }
+
+        public:
+            /**
+             * @brief Starts the given number of worker threads. The thread that
+             * runs a loop also takes part in it.
+             */
+            explicit fanout_pool(
+                std::size_t threads = std::max(1u, std::thread::hardware_concurrency()) - 1
+                )
+                : _lanes(new lane[threads + 1])
+                {
+                _threads.reserve(threads);
+                for (std::size_t i = 0; i < threads; ++i) {
+                    _threads.emplace_back([this, i]
+                        {
+                        worker(i);
+                        });
+                    }
+                }
+
+            fanout_pool(fanout_pool const&)            = delete;
+            fanout_pool& operator=(fanout_pool const&) = delete;
+
+            ~fanout_pool()
+                {
+                _stopping = true;
+                _epoch.fetch_add(1, std::memory_order_release);
+                _epoch.notify_all();
+                for (auto& t : _threads) t.join();
+                }
+
+            /**
+             * @brief Gets the number of worker threads.
+             */
+            std::size_t size() const
+                {
+                return _threads.size();
+                }
+
+            /**
+             * @brief Invokes fn(begin, end) over chunks of [0, count) in
+             * parallel, and returns once every chunk has run. If the pool is
+             * already running a loop, or is called from one of its workers, the
+             * loop runs serially on the calling thread. The first exception
+             * thrown by fn is rethrown once every chunk has run.
+             *
+             * @param count The size of the range.
+             * @param grain The number of elements in each chunk.
+             * @param fn The function to invoke.
+             */
+            template <typename Fn>
+            requires std::invocable<Fn&, std::size_t, std::size_t>
+            void parallel_for(
+                std::size_t count,
+                std::size_t grain,
+                Fn&&        fn
+                )
+                {
+                if (!count) return;
+                std::unique_lock lock(_dispatch, std::try_to_lock);
+
+                if (_threads.empty() || _current == this || !lock) {
+                    fn(std::size_t {0}, count);
+                    return;
+                    }
+
+                _grain   = std::max<std::size_t>(grain, 1);
+                _count   = count;
+                _context = &fn;
+                _run     = [](void* ctx, std::size_t begin, std::size_t end)
+                    {
+                    (*static_cast<std::remove_reference_t<Fn>*>(ctx))(begin, end);
+                    };
+                _error = nullptr;
+
+                auto chunks = (count + _grain - 1) / _grain;
+                auto lanes  = lane_count();
+
+                for (std::size_t i = 0; i < lanes; ++i) {
+                    _lanes[i].next.store(chunks * i / lanes, std::memory_order_relaxed);
+                    _lanes[i].end = chunks * (i + 1) / lanes;
+                    }
+
+                _pending.store(_threads.size(), std::memory_order_relaxed);
+                _epoch.fetch_add(1, std::memory_order_release);
+                _epoch.notify_all();
+
+                auto previous = std::exchange(_current, this);
+
+                work(lanes - 1);
+                _current = previous;
+
+                for (auto p = _pending.load(std::memory_order_acquire); p;
+                     p = _pending.load(std::memory_order_acquire)) {
+                    _pending.wait(p, std::memory_order_acquire);
+                    }
+                if (_error) std::rethrow_exception(std::exchange(_error, nullptr));
+                }
+        };
+
+
+        /**
+         * @brief Declares whether a subscriber can run concurrently with the
+         * other subscribers of a parallel_fanout.
+         */
+        enum class dispatch {
+            serial,       ///< Runs on the thread that set the property.
+            parallel_safe ///< May run on any thread of the pool.
+        };
+
+
+        /**
+         * @brief Dispatches the changes of a property to a large number of
+         * subscribers. Serial subscribers run first, in order, on the thread
+         * that set the property. Parallel-safe subscribers then run in
+         * parallel on a fanout_pool once there are at least threshold of them,
+         * and serially otherwise. The property's setter returns once every
+         * subscriber has run.
+         *
+         * Subscribers must not be connected or disconnected while a change is
+         * being dispatched.
+         *
+         * @tparam T The value type of the property.
+         */
+        template <typename T>
+        class parallel_fanout {
+            using slot_type = std::function<void(T const&)>;
+
+            std::vector<slot_type> _serial;
+            std::vector<slot_type> _parallel;
+            std::vector<std::uint64_t> _serialIds;
+            std::vector<std::uint64_t> _parallelIds;
+            std::uint64_t _nextId = 0;
+            fanout_pool* _pool;
+            std::size_t _threshold;
+            std::size_t _grain;
+            std::function<void()> _disconnect;
+
+            void dispatch_change(
+                T const& v
+                )
+                {
+                for (auto& s : _serial) s(v);
+
+                if (_parallel.size() < _threshold) {
+                    for (auto& s : _parallel) s(v);
+                    return;
+                    }
+                _pool->parallel_for(_parallel.size(), _grain, [&](std::size_t begin, std::size_t end)
+                    {
+                    for (auto i = begin; i < end; ++i) _parallel[i](v);
+                    });
+                }
+
+            static bool erase_id(
+                std::vector<slot_type>&     slots,
+                std::vector<std::uint64_t>& ids,
+                std::uint64_t               id
+                )
+                {
+                auto it = std::find(ids.begin(), ids.end(), id);
+
+                if (it == ids.end()) return false;
+                slots.erase(slots.begin() + (it - ids.begin()));
+                ids.erase(it);
+                return true;
+                }
+
+        public:
+            /**
+             * @brief Connects to the Changed signal of a property.
+             *
+             * @param prop The property to dispatch changes of.
+             * @param pool The pool to run parallel-safe subscribers on.
+             * @param threshold The number of parallel-safe subscribers from
+             * which they are run in parallel.
+             * @param grain The number of subscribers in each chunk of work.
+             */
+            template <typename Prop>
+            requires requires(Prop& p) { p.Changed; }
+            parallel_fanout(
+                Prop&        prop,
+                fanout_pool& pool,
+                std::size_t  threshold = 1024,
+                std::size_t  grain     = 256
+                )
+                : _pool(&pool)
+                , _threshold(threshold)
+                , _grain(grain)
+                {
+                auto c = prop.Changed.connect([this](T const& v)
+                    {
+                    dispatch_change(v);
+                    });
+                _disconnect = [c]() mutable
+                    {
+                    c.disconnect();
+                    };
+                }
+
+            parallel_fanout(parallel_fanout const&)            = delete;
+            parallel_fanout& operator=(parallel_fanout const&) = delete;
+
+            ~parallel_fanout()
+                {
+                _disconnect();
+                }
+
+            /**
+             * @brief Gets the number of subscribers.
+             */
+            std::size_t size() const
+                {
+                return _serial.size() + _parallel.size();
+                }
+
+            /**
+             * @brief Adds a subscriber. Parallel-safe subscribers run in no
+             * particular order.
+             *
+             * @return An id for disconnecting the subscriber.
+             */
+            template <typename Fn>
+            requires std::invocable<Fn&, T const&>
+            std::uint64_t connect(
+                Fn&&     fn,
+                dispatch mode = dispatch::serial
+                )
+                {
+                auto id = _nextId++;
+
+                if (mode == dispatch::parallel_safe) {
+                    _parallel.emplace_back(std::forward<Fn>(fn));
+                    _parallelIds.push_back(id);
+                    } else {
+                    _serial.emplace_back(std::forward<Fn>(fn));
+                    _serialIds.push_back(id);
+                    }
+                return id;
+                }
+
+            /**
+             * @brief Removes a subscriber.
+             *
+             * @return False if no subscriber has the given id.
+             */
+            bool disconnect(
+                std::uint64_t id
+                )
+                {
+                return erase_id(_parallel, _parallelIds, id) || erase_id(_serial, _serialIds, id);
+                }
+        };
+        }
+    }
+#endif
@@ -0,0 +1,317 @@
+/*
+ * Flag groups. Up to 64 bool or small enum flags of an owner are packed
+ * into one word, with a single signal that reports which flags changed.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_FLAGS_HPP
+#define MB_MEMPROP_FLAGS_HPP
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief Describes one flag of a flag_group: the bits it occupies and
+         * the type its value is read as.
+         *
+         * @tparam V The value type. Either bool, or an integral or enum type
+         * whose values are non-negative and fit in Width bits.
+         * @tparam Offset The index of the flag's lowest bit.
+         * @tparam Width The number of bits the flag occupies.
+         */
+        template <typename V, unsigned Offset, unsigned Width = 1>
+        requires (std::integral<V> || std::is_enum_v<V>)
+              && (Width > 0 && Offset + Width <= 64)
+        struct flag {
+            using value_type = V;
+
+            static constexpr unsigned offset = Offset;
+            static constexpr unsigned width  = Width;
+            static constexpr std::uint64_t mask =
+                (Width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << Width) - 1) << Offset;
+
+            /**
+             * @brief Checks whether this flag is among the bits of a
+             * changed mask.
+             */
+            static constexpr bool in(
+                std::uint64_t changed
+                )
+                {
+                return (changed & mask) != 0;
+                }
+
+            static constexpr std::uint64_t encode(
+                value_type v
+                )
+                {
+                return static_cast<std::uint64_t>(v) << Offset & mask;
+                }
+
+            static constexpr value_type decode(
+                std::uint64_t bits
+                )
+                {
+                if constexpr (std::same_as<V, bool>) {
+                    return (bits & mask) != 0;
+                    } else {
+                    return static_cast<value_type>((bits & mask) >> Offset);
+                    }
+                }
+        };
+
+
+        namespace detail {
+            template <typename F>
+            concept FlagField = requires {
+                typename F::value_type;
+                { F::mask }->std::convertible_to<std::uint64_t>;
+                { F::decode(std::uint64_t{}) }->std::same_as<typename F::value_type>;
+                };
+
+
+            template <typename Group, typename Flag, typename PSrc,
+                      typename Converter = detail::dummy_converter>
+            class flag_binding
+                : public basic_binding<typename traits::policy_type<PSrc>::connection> {
+                Group* _group;
+                Converter _converter;
+
+                void set_flag(
+                    traits::const_reference<PSrc> v
+                    )
+                    {
+                    if constexpr (!std::same_as<Converter, detail::dummy_converter>) {
+                        _group->template set<Flag>(_converter(v));
+                        } else {
+                        _group->template set<Flag>(v);
+                        }
+                    }
+
+                void on_changed(
+                    traits::const_reference<PSrc> v
+                    )
+                    {
+                    if (propagation_frame::active(this)) return;
+                    propagation_frame frame(this);
+                    set_flag(v);
+                    }
+
+            public:
+                flag_binding(
+                    Group*               group,
+                    settable_prop<PSrc>* src,
+                    Converter&&          converter = Converter{}
+                    )
+                    : _group(group)
+                    , _converter(std::forward<Converter>(converter))
+                    {
+                    set_flag(property_access::get(*src));
+                    this->_connection = src->Changed.connect(&flag_binding::on_changed, this);
+                    }
+            };
+            }
+
+
+        /**
+         * @brief Holds up to 64 bits of flags in a single word, in place of a
+         * property object per flag. Each flag, described by a flag type, can
+         * be read, set and bound on its own. Changed is emitted once per
+         * update with the mask of the bits that changed, and updates made
+         * within a batch are reported together.
+         *
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
+         */
+        template <detail::ThreadingPolicy Policy = thread_safe>
+        class flag_group {
+            std::uint64_t _bits;
+            std::uint64_t _batchStart = 0;
+            unsigned _batchDepth = 0;
+            std::vector<std::pair<std::uint64_t, std::shared_ptr<binding>>> _bindings;
+
+            void reset_binding(
+                std::uint64_t mask
+                )
+                {
+                auto it = std::find_if(_bindings.begin(), _bindings.end(), [&](auto const& b)
+                    {
+                    return b.first == mask;
+                    });
+
+                if (it == _bindings.end()) return;
+                it->second->disconnect();
+                _bindings.erase(it);
+                }
+
+            template <typename Flag, typename Binding>
+            std::shared_ptr<binding> store_binding(
+                std::shared_ptr<Binding> b
+                )
+                {
+                _bindings.emplace_back(Flag::mask, b);
+                return b;
+                }
+
+        public:
+            /**
+             * @brief Emitted with the mask of the bits that changed.
+             */
+            typename Policy::template signal<flag_group, std::uint64_t> Changed;
+
+            /**
+             * @brief Defers Changed until the last open batch of the group is
+             * closed, then emits it once with the bits that differ from when
+             * the first batch was opened.
+             */
+            class batch {
+                flag_group& _group;
+
+            public:
+                explicit batch(
+                    flag_group& group
+                    )
+                    : _group(group)
+                    {
+                    if (_group._batchDepth++ == 0) _group._batchStart = _group._bits;
+                    }
+
+                batch(batch const&)            = delete;
+                batch& operator=(batch const&) = delete;
+
+                ~batch()
+                    {
+                    if (--_group._batchDepth == 0 && _group._bits != _group._batchStart) {
+                        _group.Changed(_group._bits ^ _group._batchStart);
+                        }
+                    }
+            };
+
+
+            explicit flag_group(
+                std::uint64_t bits = 0
+                )
+                : _bits(bits)
+                {
+                }
+
+            flag_group(flag_group const&)            = delete;
+            flag_group& operator=(flag_group const&) = delete;
+
+            ~flag_group()
+                {
+                for (auto& b : _bindings) b.second->disconnect();
+                }
+
+            /**
+             * @brief Gets the bits of every flag in the group.
+             */
+            std::uint64_t bits() const
+                {
+                return _bits;
+                }
+
+            template <detail::FlagField Flag>
+            typename Flag::value_type get() const
+                {
+                return Flag::decode(_bits);
+                }
+
+            /**
+             * @brief Sets the value of one flag.
+             *
+             * @return Whether the value changed.
+             */
+            template <detail::FlagField Flag>
+            bool set(
+                typename Flag::value_type v
+                )
+                {
+                return assign(Flag::mask, Flag::encode(v));
+                }
+
+            /**
+             * @brief Sets several bits at once, emitting Changed once for all
+             * of them.
+             *
+             * @param mask The bits to set.
+             * @param bits The new values of those bits.
+             *
+             * @return Whether any bit changed.
+             */
+            bool assign(
+                std::uint64_t mask,
+                std::uint64_t bits
+                )
+                {
+                auto next    = (_bits & ~mask) | (bits & mask);
+                auto changed = next ^ _bits;
+
+                if (!changed) return false;
+                _bits = next;
+
+                if (!_batchDepth) Changed(changed);
+                return true;
+                }
+
+            /**
+             * @brief Binds one flag to the value of a property, replacing any
+             * binding the flag already has.
+             *
+             * @param src The source property.
+             *
+             * @return A handle to the binding.
+             */
+            template <detail::FlagField Flag, typename PSrc>
+            requires std::convertible_to<detail::traits::const_reference<PSrc>,
+                                         typename Flag::value_type>
+            std::shared_ptr<binding> bind(
+                detail::settable_prop<PSrc>& src
+                )
+                {
+                reset_binding(Flag::mask);
+                using binding_t = detail::flag_binding<flag_group, Flag, PSrc>;
+                return store_binding<Flag>(std::make_shared<binding_t>(this, &src));
+                }
+
+            /**
+             * @brief Binds one flag to the value of a property using the given
+             * converter object.
+             *
+             * @param src The source property.
+             * @param converter A functor that accepts a const reference to the
+             * source's value type and returns the flag's value type.
+             *
+             * @return A handle to the binding.
+             */
+            template <detail::FlagField Flag, typename PSrc, typename Converter>
+            requires std::convertible_to<
+                std::invoke_result_t<Converter&, detail::traits::const_reference<PSrc>>,
+                typename Flag::value_type>
+            std::shared_ptr<binding> bind(
+                detail::settable_prop<PSrc>& src,
+                Converter&&                  converter
+                )
+                {
+                reset_binding(Flag::mask);
+                using binding_t = detail::flag_binding<flag_group, Flag, PSrc, Converter>;
+                return store_binding<Flag>(std::make_shared<binding_t>(
+                                               this, &src, std::forward<Converter>(converter)));
+                }
+
+            /**
+             * @brief Removes the binding from one flag, if one exists.
+             */
+            template <detail::FlagField Flag>
+            void unbind()
+                {
+                reset_binding(Flag::mask);
+                }
+        };
+        }
+    }
+#endif
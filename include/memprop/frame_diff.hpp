@@ -0,0 +1,381 @@
+/*
+ * Frame-to-frame change detection for numeric property values.
+ * Values are captured into contiguous snapshots, and changed indices
+ * are found with vectorized comparison kernels.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_FRAME_DIFF_HPP
+#define MB_MEMPROP_FRAME_DIFF_HPP
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+#if !defined(MEMPROP_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MEMPROP_DIFF_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MEMPROP_DIFF_SSE2
+#endif
+#endif
+
+namespace mousebyte {
+    namespace memprop {
+        namespace detail {
+            template <typename T>
+            concept DiffableValue = std::is_trivially_copyable_v<T>
+                                    && (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                                    && (sizeof(T) == 1 || sizeof(T) == 2
+                                        || sizeof(T) == 4 || sizeof(T) == 8);
+
+            // Turns a mask with one bit per differing byte into a mask with
+            // one bit per differing element of the given size.
+            template <std::size_t Size>
+            inline std::uint64_t element_mask(
+                std::uint64_t byteMask,
+                std::size_t   elements
+                )
+                {
+                if constexpr (Size == 1) {
+                    return byteMask;
+                    } else {
+                    std::uint64_t result = 0;
+                    constexpr std::uint64_t group = (std::uint64_t{1} << Size) - 1;
+
+                    for (std::size_t j = 0; j < elements; ++j) {
+                        if (byteMask >> (j * Size) & group) result |= std::uint64_t{1} << j;
+                        }
+                    return result;
+                    }
+                }
+
+            // Compares one block of Width bytes and returns a mask with one bit
+            // per differing byte. A width of 8 uses the portable scalar kernel.
+            template <std::size_t Width>
+            inline std::uint64_t diff_block(
+                std::byte const* a,
+                std::byte const* b
+                )
+                {
+                if constexpr (Width == 8) {
+                    std::uint64_t wa, wb;
+
+                    std::memcpy(&wa, a, 8);
+                    std::memcpy(&wb, b, 8);
+                    auto x = wa ^ wb;
+
+                    if (!x) return 0;
+                    std::uint64_t mask = 0;
+
+                    for (std::size_t i = 0; i < 8; ++i) {
+                        if (x >> (i * 8) & 0xFF) mask |= std::uint64_t{1} << i;
+                        }
+                    return mask;
+                    }
+#if defined(MEMPROP_DIFF_AVX2)
+                else if constexpr (Width == 32) {
+                    auto va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a));
+                    auto vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b));
+                    auto eq = static_cast<std::uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+                    return static_cast<std::uint32_t>(~eq);
+                    }
+#endif
+#if defined(MEMPROP_DIFF_AVX2) || defined(MEMPROP_DIFF_SSE2)
+                else if constexpr (Width == 16) {
+                    auto va = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a));
+                    auto vb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b));
+                    auto eq = static_cast<std::uint32_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+                    return ~eq & 0xFFFFu;
+                    }
+#endif
+                else {
+                    static_assert(Width == 8, "unsupported diff block width");
+                    }
+                }
+
+#if defined(MEMPROP_DIFF_AVX2)
+            inline constexpr std::size_t diff_block_width = 32;
+#elif defined(MEMPROP_DIFF_SSE2)
+            inline constexpr std::size_t diff_block_width = 16;
+#else
+            inline constexpr std::size_t diff_block_width = 8;
+#endif
+
+            // Sets bit i of words for every index i where previous and current
+            // differ bitwise. words must be zeroed and hold at least
+            // ceil(count / 64) elements.
+            template <DiffableValue T, std::size_t Width = diff_block_width>
+            void diff_kernel(
+                T const*       previous,
+                T const*       current,
+                std::size_t    count,
+                std::uint64_t* words
+                )
+                {
+                constexpr std::size_t perBlock = Width / sizeof(T);
+                auto                  a        = reinterpret_cast<std::byte const*>(previous);
+                auto                  b        = reinterpret_cast<std::byte const*>(current);
+                std::size_t           i        = 0;
+
+                for (; i + perBlock <= count; i += perBlock) {
+                    auto bytes = diff_block<Width>(a + i * sizeof(T), b + i * sizeof(T));
+
+                    // blocks hold a power of two number of elements no larger
+                    // than 64, so a block never straddles two words
+                    if (bytes) words[i / 64] |= element_mask<sizeof(T)>(bytes, perBlock) << (i % 64);
+                    }
+
+                for (; i < count; ++i) {
+                    if (std::memcmp(previous + i, current + i, sizeof(T)) != 0) {
+                        words[i / 64] |= std::uint64_t{1} << (i % 64);
+                        }
+                    }
+                }
+            }
+
+
+        /**
+         * @brief A fixed-size set of bits marking which values of a snapshot
+         * have changed.
+         */
+        class changed_bitset {
+            std::vector<std::uint64_t> _words;
+            std::size_t _size = 0;
+
+        public:
+            /**
+             * @brief Clears the bitset and resizes it to hold the given number
+             * of bits.
+             */
+            void reset(
+                std::size_t size
+                )
+                {
+                _size = size;
+                _words.assign((size + 63) / 64, 0);
+                }
+
+            /**
+             * @brief Gets the number of bits in the set.
+             */
+            std::size_t size() const
+                {
+                return _size;
+                }
+
+            /**
+             * @brief Checks whether the bit at the given index is set.
+             */
+            bool test(
+                std::size_t index
+                ) const
+                {
+                return _words[index / 64] >> (index % 64) & 1;
+                }
+
+            /**
+             * @brief Sets the bit at the given index.
+             */
+            void set(
+                std::size_t index
+                )
+                {
+                _words[index / 64] |= std::uint64_t{1} << (index % 64);
+                }
+
+            /**
+             * @brief Counts the set bits.
+             */
+            std::size_t count() const
+                {
+                std::size_t n = 0;
+
+                for (auto w : _words) n += std::popcount(w);
+                return n;
+                }
+
+            /**
+             * @brief Checks whether any bit is set.
+             */
+            bool any() const
+                {
+                for (auto w : _words) {
+                    if (w) return true;
+                    }
+                return false;
+                }
+
+            /**
+             * @brief Invokes the given function with the index of each set bit,
+             * in ascending order.
+             */
+            template <typename Fn>
+            requires std::invocable<Fn&, std::size_t>
+            void for_each(
+                Fn&& fn
+                ) const
+                {
+                for (std::size_t w = 0; w < _words.size(); ++w) {
+                    for (auto bits = _words[w]; bits; bits &= bits - 1) {
+                        fn(w * 64 + std::countr_zero(bits));
+                        }
+                    }
+                }
+
+            /**
+             * @brief Gets the underlying words, 64 bits per word.
+             */
+            std::span<std::uint64_t const> words() const
+                {
+                return _words;
+                }
+
+            std::span<std::uint64_t> words()
+                {
+                return _words;
+                }
+        };
+
+
+        /**
+         * @brief Finds the values that differ between two buffers. Values are
+         * compared bitwise, so a NaN that is unchanged is not reported, and a
+         * change of sign on zero is. Values past the end of the shorter buffer
+         * are reported as changed.
+         *
+         * @param previous The earlier values.
+         * @param current The later values.
+         * @param out Receives one bit per element of current.
+         */
+        template <detail::DiffableValue T>
+        void diff(
+            std::span<T const> previous,
+            std::span<T const> current,
+            changed_bitset&    out
+            )
+            {
+            out.reset(current.size());
+            auto common = std::min(previous.size(), current.size());
+
+            detail::diff_kernel(previous.data(), current.data(), common, out.words().data());
+
+            for (auto i = common; i < current.size(); ++i) out.set(i);
+            }
+
+        /**
+         * @brief Finds the values that differ between two buffers, and appends
+         * their indices to a list in ascending order.
+         *
+         * @param previous The earlier values.
+         * @param current The later values.
+         * @param scratch A bitset to use as working storage.
+         * @param out The list that receives the changed indices.
+         */
+        template <detail::DiffableValue T>
+        void diff(
+            std::span<T const>          previous,
+            std::span<T const>          current,
+            changed_bitset&             scratch,
+            std::vector<std::uint32_t>& out
+            )
+            {
+            diff(previous, current, scratch);
+            scratch.for_each([&](std::size_t i)
+                {
+                out.push_back(static_cast<std::uint32_t>(i));
+                });
+            }
+
+
+        /**
+         * @brief Captures numeric values into a pair of contiguous buffers, so
+         * that the values which changed between two captures can be found.
+         *
+         * @tparam T The value type.
+         */
+        template <detail::DiffableValue T>
+        class numeric_snapshot {
+            std::vector<T> _previous;
+            std::vector<T> _current;
+            changed_bitset _changed;
+
+        public:
+            /**
+             * @brief Captures a new set of values. The values captured last
+             * become the previous values.
+             *
+             * @param values The values to capture.
+             */
+            void capture(
+                std::span<T const> values
+                )
+                {
+                _previous.swap(_current);
+                _current.assign(values.begin(), values.end());
+                }
+
+            /**
+             * @brief Captures the values of a range of properties, or of
+             * pointers to properties.
+             *
+             * @param props The properties to capture.
+             */
+            template <std::ranges::input_range R>
+            requires (!std::convertible_to<R, std::span<T const>>)
+            void capture(
+                R&& props
+                )
+                {
+                _previous.swap(_current);
+                _current.clear();
+
+                for (auto&& p : props) {
+                    if constexpr (std::is_pointer_v<std::remove_cvref_t<decltype(p)>>) {
+                        _current.push_back(static_cast<T>(*p));
+                        } else {
+                        _current.push_back(static_cast<T>(p));
+                        }
+                    }
+                }
+
+            /**
+             * @brief Gets the values from the last capture.
+             */
+            std::span<T const> values() const
+                {
+                return _current;
+                }
+
+            /**
+             * @brief Gets a bitset of the values that changed between the last
+             * two captures. On the first capture every value is reported.
+             */
+            changed_bitset const& changed()
+                {
+                diff(std::span<T const>(_previous), std::span<T const>(_current), _changed);
+                return _changed;
+                }
+
+            /**
+             * @brief Appends the indices of the values that changed between the
+             * last two captures to the given list.
+             */
+            void changed(
+                std::vector<std::uint32_t>& out
+                )
+                {
+                diff(std::span<T const>(_previous), std::span<T const>(_current), _changed, out);
+                }
+        };
+        }
+    }
+#endif
@@ -0,0 +1,448 @@
+/*
+ * Bounded undo/redo history recorded at the property layer. Old and new
+ * values of each set are captured into a fixed-capacity ring arena, and
+ * the oldest records are evicted when the arena is full.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_HISTORY_HPP
+#define MB_MEMPROP_HISTORY_HPP
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        namespace detail {
+            // Rounds a size up to a multiple of the fundamental alignment.
+            constexpr std::uint32_t history_align(
+                std::size_t n
+                )
+                {
+                constexpr std::size_t align = alignof(std::max_align_t);
+                return static_cast<std::uint32_t>((n + align - 1) / align * align);
+                }
+            }
+
+
+        /**
+         * @brief Records the changes made to the properties of attached owners,
+         * so that they can be undone and redone. Records are kept in a ring
+         * arena of a fixed number of bytes; when a new record does not fit,
+         * the oldest records are discarded.
+         *
+         * Consecutive sets of the same property are merged into one record
+         * until the history is sealed, and the records made between
+         * begin_group() and end_group() are undone and redone together.
+         * Undoing and redoing set properties through their setters, so
+         * Changed is emitted, but nothing is recorded while they run.
+         */
+        class property_history {
+            friend class history_tracking;
+            template <typename>
+            friend class detail::settable_prop;
+
+            static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+            struct record_ops {
+                void (* apply)(void*, void const*);
+                void (* assign)(void*, void const*);
+                void (* destroy)(void*);
+                std::uint32_t value_size;
+            };
+
+            struct entry {
+                history_tracking* owner;
+                void* prop;
+                record_ops const* ops;
+                std::uint32_t size;
+                std::uint32_t prev;
+                std::uint32_t next;
+                std::uint32_t group;
+            };
+
+
+            static constexpr std::uint32_t header_size = detail::history_align(sizeof(entry));
+
+            // Each record is a header followed by the old and the new value.
+            template <typename Prop>
+            struct record_type {
+                using value_type = detail::traits::value_type<Prop>;
+
+                static_assert(alignof(value_type) <= alignof(std::max_align_t),
+                              "Over-aligned property values cannot be recorded.");
+
+                static constexpr std::uint32_t size = header_size + detail::history_align(2 * sizeof(value_type));
+
+                static void apply(
+                    void*       prop,
+                    void const* value
+                    )
+                    {
+                    detail::property_access::replay(*static_cast<detail::settable_prop<Prop>*>(prop),
+                                                    *static_cast<value_type const*>(value));
+                    }
+
+                static void assign(
+                    void*       dst,
+                    void const* src
+                    )
+                    {
+                    *static_cast<value_type*>(dst) = *static_cast<value_type const*>(src);
+                    }
+
+                static void destroy(
+                    void* values
+                    )
+                    {
+                    auto v = static_cast<value_type*>(values);
+                    std::destroy_at(v);
+                    std::destroy_at(v + 1);
+                    }
+
+                static constexpr record_ops ops {&apply, &assign, &destroy, sizeof(value_type)};
+            };
+
+
+            std::unique_ptr<std::byte[]> _arena;
+            std::uint32_t _capacity;
+            std::uint32_t _first  = npos;
+            std::uint32_t _last   = npos;
+            std::uint32_t _cursor = npos;
+            std::uint32_t _nextGroup = 0;
+            std::uint32_t _openGroup = 0;
+            std::uint32_t _groupDepth = 0;
+            std::size_t _count = 0;
+            bool _sealed = true;
+            bool _applying = false;
+
+            entry& at(
+                std::uint32_t offset
+                ) const
+                {
+                return *std::launder(reinterpret_cast<entry*>(_arena.get() + offset));
+                }
+
+            static void* old_value(
+                entry& r
+                )
+                {
+                return reinterpret_cast<std::byte*>(&r) + header_size;
+                }
+
+            static void* new_value(
+                entry& r
+                )
+                {
+                return static_cast<std::byte*>(old_value(r)) + r.ops->value_size;
+                }
+
+            void unlink(
+                std::uint32_t offset
+                )
+                {
+                auto& r = at(offset);
+
+                if (r.prev != npos) at(r.prev).next = r.next;
+                else _first = r.next;
+                if (r.next != npos) at(r.next).prev = r.prev;
+                else _last = r.prev;
+                if (_cursor == offset) _cursor = r.prev;
+
+                r.ops->destroy(old_value(r));
+                std::destroy_at(&r);
+                --_count;
+                }
+
+            // Finds room for a record of the given size after the newest
+            // record, evicting the oldest records as needed.
+            std::uint32_t allocate(
+                std::uint32_t size
+                )
+                {
+                while (_first != npos) {
+                    auto end = _last + at(_last).size;
+
+                    if (_last >= _first) {
+                        if (_capacity - end >= size) return end;
+                        if (_first >= size) return 0;
+                        } else if (_first - end >= size) {
+                        return end;
+                        }
+                    unlink(_first);
+                    }
+                return 0;
+                }
+
+            bool recording() const
+                {
+                return !_applying;
+                }
+
+            template <typename Prop>
+            void record(
+                history_tracking&                owner,
+                detail::settable_prop<Prop>&     prop,
+                detail::traits::value_type<Prop> const& old,
+                detail::traits::const_reference<Prop>   now
+                )
+                {
+                using type = record_type<Prop>;
+
+                while (_last != _cursor) unlink(_last);
+
+                if (!_sealed && _last != npos && at(_last).prop == &prop) {
+                    type::assign(new_value(at(_last)), &now);
+                    return;
+                    }
+
+                if (type::size > _capacity) {
+                    clear();
+                    return;
+                    }
+
+                auto offset = allocate(type::size);
+                auto r      = ::new (_arena.get() + offset) entry {
+                    &owner, &prop, &type::ops, type::size, _last, npos,
+                    _groupDepth ? _openGroup : _nextGroup++
+                    };
+                auto values = static_cast<typename type::value_type*>(old_value(*r));
+
+                ::new (values) typename type::value_type(old);
+                ::new (values + 1) typename type::value_type(now);
+
+                if (_last != npos) at(_last).next = offset;
+                else _first = offset;
+                _last   = offset;
+                _cursor = offset;
+                _sealed = false;
+                ++_count;
+                }
+
+            void forget(
+                history_tracking const* owner
+                )
+                {
+                for (auto offset = _first; offset != npos;) {
+                    auto next = at(offset).next;
+
+                    if (at(offset).owner == owner) unlink(offset);
+                    offset = next;
+                    }
+                }
+
+        public:
+            /**
+             * @brief Creates a history with an arena of the given number of bytes.
+             */
+            explicit property_history(
+                std::size_t capacity
+                )
+                : _arena(new std::byte[capacity]),
+                _capacity(static_cast<std::uint32_t>(capacity))
+                {
+                }
+
+            property_history(property_history const&)            = delete;
+            property_history& operator=(property_history const&) = delete;
+
+            ~property_history()
+                {
+                clear();
+                }
+
+            /**
+             * @brief Gets the capacity of the arena in bytes.
+             */
+            std::size_t capacity() const
+                {
+                return _capacity;
+                }
+
+            /**
+             * @brief Gets the number of records held, including those that
+             * have been undone.
+             */
+            std::size_t size() const
+                {
+                return _count;
+                }
+
+            /**
+             * @brief Checks whether there is a change to undo.
+             */
+            bool can_undo() const
+                {
+                return _cursor != npos;
+                }
+
+            /**
+             * @brief Checks whether there is an undone change to redo.
+             */
+            bool can_redo() const
+                {
+                return (_cursor == npos ? _first : at(_cursor).next) != npos;
+                }
+
+            /**
+             * @brief Discards every record.
+             */
+            void clear()
+                {
+                while (_last != npos) unlink(_last);
+                _sealed = true;
+                }
+
+            /**
+             * @brief Ends merging, so that the next set of any property starts
+             * a new record. Call at the end of an interactive edit.
+             */
+            void seal()
+                {
+                _sealed = true;
+                }
+
+            /**
+             * @brief Starts a group of changes that are undone and redone
+             * together. Groups may be nested, and end with the outermost call
+             * to end_group().
+             */
+            void begin_group()
+                {
+                if (_groupDepth++ == 0) {
+                    _openGroup = _nextGroup++;
+                    _sealed    = true;
+                    }
+                }
+
+            /**
+             * @brief Ends a group of changes started with begin_group().
+             */
+            void end_group()
+                {
+                if (_groupDepth && --_groupDepth == 0) _sealed = true;
+                }
+
+            /**
+             * @brief Restores the old values of the most recent group of changes.
+             *
+             * @return False if there was nothing to undo.
+             */
+            bool undo()
+                {
+                if (_cursor == npos) return false;
+                auto group    = at(_cursor).group;
+                auto applying = std::exchange(_applying, true);
+
+                while (_cursor != npos && at(_cursor).group == group) {
+                    auto& r = at(_cursor);
+
+                    _cursor = r.prev;
+                    r.ops->apply(r.prop, old_value(r));
+                    }
+                _applying = applying;
+                _sealed   = true;
+                return true;
+                }
+
+            /**
+             * @brief Reapplies the new values of the most recently undone group
+             * of changes.
+             *
+             * @return False if there was nothing to redo.
+             */
+            bool redo()
+                {
+                auto next = _cursor == npos ? _first : at(_cursor).next;
+
+                if (next == npos) return false;
+                auto group    = at(next).group;
+                auto applying = std::exchange(_applying, true);
+
+                while (next != npos && at(next).group == group) {
+                    auto& r = at(next);
+
+                    _cursor = next;
+                    next    = r.next;
+                    r.ops->apply(r.prop, new_value(r));
+                    }
+                _applying = applying;
+                _sealed   = true;
+                return true;
+                }
+        };
+
+
+        /**
+         * @brief Groups the changes recorded during its lifetime, so that they
+         * are undone and redone together.
+         */
+        class history_group {
+            property_history& _history;
+
+        public:
+            explicit history_group(
+                property_history& history
+                )
+                : _history(history)
+                {
+                _history.begin_group();
+                }
+
+            history_group(history_group const&)            = delete;
+            history_group& operator=(history_group const&) = delete;
+
+            ~history_group()
+                {
+                _history.end_group();
+                }
+        };
+
+
+        /**
+         * @brief Base class for owners whose property changes can be recorded
+         * in a property_history. Recording starts once a history is attached.
+         * The records of an owner are discarded when it is destroyed, and the
+         * history must outlive its attached owners.
+         */
+        class history_tracking {
+            property_history* _history = nullptr;
+
+        protected:
+            history_tracking() = default;
+
+            ~history_tracking()
+                {
+                if (_history) _history->forget(this);
+                }
+
+        public:
+            history_tracking(history_tracking const&)            = delete;
+            history_tracking& operator=(history_tracking const&) = delete;
+
+            /**
+             * @brief Attaches a history to record changes to, or detaches the
+             * current history if null. The records of this owner in the
+             * previously attached history are discarded.
+             */
+            void record_history(
+                property_history* history
+                )
+                {
+                if (_history && _history != history) _history->forget(this);
+                _history = history;
+                }
+
+            /**
+             * @brief Gets the attached history, or null.
+             */
+            property_history* history() const
+                {
+                return _history;
+                }
+        };
+        }
+    }
+#endif
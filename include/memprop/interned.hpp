@@ -0,0 +1,323 @@
+/*
+ * Interned strings, and a string property that stores one. Each distinct
+ * string is kept once in a global pool, so a value is a single pointer,
+ * and equal values compare by identity.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_INTERNED_HPP
+#define MB_MEMPROP_INTERNED_HPP
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memprop/snapshot.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        namespace detail {
+            struct interned_entry {
+                std::string_view text;
+            };
+
+
+            inline constexpr interned_entry empty_interned {""};
+
+            /**
+             * @brief Holds each distinct interned string once. Strings are
+             * never removed, so entries stay valid for the life of the
+             * program. Lookups of strings already interned take a shared lock.
+             */
+            class intern_pool {
+                std::deque<std::string> _storage;
+                std::deque<interned_entry> _entries;
+                std::unordered_map<std::string_view, interned_entry const*> _index {
+                    {empty_interned.text, &empty_interned}
+                    };
+                mutable std::shared_mutex _mutex;
+
+            public:
+                interned_entry const* intern(
+                    std::string_view s
+                    )
+                    {
+                    {
+                    std::shared_lock lock(_mutex);
+
+                    if (auto it = _index.find(s); it != _index.end()) return it->second;
+                    }
+                    std::unique_lock lock(_mutex);
+
+                    if (auto it = _index.find(s); it != _index.end()) return it->second;
+                    auto& entry = _entries.emplace_back(interned_entry {_storage.emplace_back(s)});
+
+                    _index.emplace(entry.text, &entry);
+                    return &entry;
+                    }
+
+                std::size_t size() const
+                    {
+                    std::shared_lock lock(_mutex);
+                    return _index.size();
+                    }
+            };
+
+
+            inline intern_pool& global_intern_pool()
+                {
+                static intern_pool pool;
+                return pool;
+                }
+            }
+
+
+        /**
+         * @brief An immutable string stored once in a global pool. Copying
+         * and comparing interned strings only touches a pointer; constructing
+         * one from other text looks it up in the pool.
+         *
+         * Interned strings are not trivially copyable, so that snapshots and
+         * mapped or shared layouts do not copy the pointer, which is only
+         * meaningful within one process.
+         */
+        class interned_string {
+            detail::interned_entry const* _entry = &detail::empty_interned;
+
+        public:
+            constexpr interned_string() noexcept = default;
+
+            constexpr interned_string(
+                interned_string const& other
+                ) noexcept
+                : _entry(other._entry)
+                {
+                }
+
+            constexpr interned_string& operator=(
+                interned_string const& other
+                ) noexcept
+                {
+                _entry = other._entry;
+                return *this;
+                }
+
+            interned_string(
+                std::string_view s
+                )
+                : _entry(detail::global_intern_pool().intern(s))
+                {
+                }
+
+            interned_string(
+                std::string const& s
+                )
+                : interned_string(std::string_view(s))
+                {
+                }
+
+            interned_string(
+                char const* s
+                )
+                : interned_string(std::string_view(s))
+                {
+                }
+
+            /**
+             * @brief Gets the number of distinct strings interned so far,
+             * including the empty string.
+             */
+            static std::size_t pool_size()
+                {
+                return detail::global_intern_pool().size();
+                }
+
+            std::string_view view() const noexcept
+                {
+                return _entry->text;
+                }
+
+            operator std::string_view() const noexcept
+                {
+                return _entry->text;
+                }
+
+            /**
+             * @brief Gets the string as a null-terminated character array.
+             */
+            char const* c_str() const noexcept
+                {
+                return _entry->text.data();
+                }
+
+            std::size_t size() const noexcept
+                {
+                return _entry->text.size();
+                }
+
+            bool empty() const noexcept
+                {
+                return _entry->text.empty();
+                }
+
+            friend bool operator==(
+                interned_string const& lhs,
+                interned_string const& rhs
+                ) noexcept
+                {
+                return lhs._entry == rhs._entry;
+                }
+
+            friend bool operator==(
+                interned_string const& lhs,
+                std::string_view       rhs
+                ) noexcept
+                {
+                return lhs.view() == rhs;
+                }
+
+            friend bool operator==(
+                interned_string const& lhs,
+                char const*            rhs
+                ) noexcept
+                {
+                return lhs.view() == rhs;
+                }
+
+            friend std::hash<interned_string>;
+        };
+
+
+        template <>
+        struct serializer<interned_string> {
+            static constexpr std::string_view tag = "string8";
+
+            static void write(
+                interned_string const& v,
+                byte_writer&           out
+                )
+                {
+                out.write(static_cast<std::uint32_t>(v.size()));
+                out.write(v.c_str(), v.size());
+                }
+
+            static bool read(
+                byte_reader&     in,
+                interned_string& v
+                )
+                {
+                std::uint32_t size;
+
+                if (!in.read(size)) return false;
+                auto bytes = in.take(size);
+
+                if (bytes.size() != size) return false;
+                v = std::string_view(reinterpret_cast<char const*>(bytes.data()), size);
+                return true;
+                }
+        };
+
+
+        template <typename Owner, detail::ThreadingPolicy Policy>
+        class interned_property;
+
+        namespace detail {
+            template <typename Owner, detail::ThreadingPolicy Policy>
+            struct property_traits<interned_property<Owner, Policy>> {
+                using owner_type      = Owner;
+                using property_type   = interned_property<Owner, Policy>;
+                using value_type      = interned_string;
+                using const_reference = interned_string const&;
+                using policy_type     = Policy;
+            };
+            }
+
+
+        /**
+         * @brief Exposes a public string property that holds an interned
+         * string. Setting it to the string it already holds does not emit
+         * Changed, which is detected by comparing pointers.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
+         */
+        template <typename Owner, detail::ThreadingPolicy Policy = thread_safe>
+        class interned_property
+            : public public_property_base<interned_property<Owner, Policy>> {
+            using my_type = interned_property<Owner, Policy>;
+
+            friend Owner;
+        public:
+            using value_type      = detail::traits::value_type<my_type>;
+            using const_reference = detail::traits::const_reference<my_type>;
+            interned_property(
+                Owner* owner
+                )
+                : public_property_base<my_type>(owner)
+                {
+                }
+
+            interned_property(
+                Owner*          owner,
+                const_reference v
+                )
+                : public_property_base<my_type>(owner)
+                , _value(v)
+                {
+                }
+
+            my_type& operator=(
+                const_reference rhs
+                )
+                {
+                this->set(rhs);
+                return *this;
+                }
+
+            /**
+             * @brief Gets the value as a string view.
+             */
+            std::string_view view() const noexcept
+                {
+                return _value.view();
+                }
+
+            operator std::string_view() const noexcept
+                {
+                return _value.view();
+                }
+
+        protected:
+            const_reference get() const override
+                {
+                return _value;
+                }
+
+        private:
+            bool do_set(
+                const_reference v
+                ) override
+                {
+                if (_value == v) return false;
+                _value = v;
+                return true;
+                }
+
+            value_type _value;
+        };
+        }
+    }
+
+
+template <>
+struct std::hash<mousebyte::memprop::interned_string> {
+    std::size_t operator()(
+        mousebyte::memprop::interned_string const& s
+        ) const noexcept
+        {
+        return std::hash<void const*>{}(s._entry);
+        }
+};
+#endif
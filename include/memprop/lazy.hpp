@@ -0,0 +1,311 @@
+/*
+ * Lazy properties, whose value is converted from a bound source property
+ * only when it is read. Source changes only mark the value stale, and are
+ * announced by a signal that carries no value.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_LAZY_HPP
+#define MB_MEMPROP_LAZY_HPP
+#include <atomic>
+#include <memory>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        template <typename Owner, typename V, detail::ThreadingPolicy Policy>
+        class lazy_property;
+
+        namespace detail {
+            template <typename Owner, typename V, detail::ThreadingPolicy Policy>
+            struct property_traits<lazy_property<Owner, V, Policy>> {
+                using owner_type      = Owner;
+                using property_type   = lazy_property<Owner, V, Policy>;
+                using value_type      = std::remove_cvref_t<V>;
+                using const_reference = value_type const&;
+                using policy_type     = Policy;
+            };
+
+
+            /**
+             * @brief The side of a lazy binding its target pulls values from.
+             */
+            template <typename Prop>
+            class lazy_source {
+            public:
+                Prop* target;
+
+                virtual ~lazy_source() = default;
+
+                /**
+                 * @brief Checks whether the source has changed since the
+                 * given version was converted.
+                 */
+                virtual bool stale(std::uint32_t seen) const = 0;
+
+                /**
+                 * @brief Converts the source's value into out if it has
+                 * changed since seen, and updates seen.
+                 *
+                 * @return Whether out was written.
+                 */
+                virtual bool refresh(
+                    traits::value_type<Prop>& out,
+                    std::uint32_t&            seen
+                    ) = 0;
+            };
+
+
+            template <typename PSrc, typename PTarget, typename Converter = detail::dummy_converter>
+            class lazy_binding_impl
+                : public basic_binding<typename traits::policy_type<PSrc>::connection>
+                , public lazy_source<PTarget> {
+                property_ref<PSrc> _source;
+                Converter _converter;
+
+                void on_changed(
+                    traits::const_reference<PSrc>
+                    )
+                    {
+                    this->target->invalidate();
+                    }
+
+            public:
+                lazy_binding_impl(
+                    PTarget*             target,
+                    settable_prop<PSrc>* src,
+                    Converter&&          converter = Converter{}
+                    )
+                    : _source(src)
+                    , _converter(std::forward<Converter>(converter))
+                    {
+                    this->target      = target;
+                    this->_connection = src->Changed.connect(&lazy_binding_impl::on_changed, this);
+                    }
+
+                bool stale(
+                    std::uint32_t seen
+                    ) const override
+                    {
+                    return _source && this->_connection.connected() && _source->version() != seen;
+                    }
+
+                bool refresh(
+                    traits::value_type<PTarget>& out,
+                    std::uint32_t&               seen
+                    ) override
+                    {
+                    if (!stale(seen)) return false;
+                    seen = _source->version();
+
+                    if constexpr (!std::same_as<Converter, detail::dummy_converter>) {
+                        out = _converter(property_access::get(*_source));
+                        } else {
+                        out = property_access::get(*_source);
+                        }
+                    return true;
+                    }
+            };
+            }
+
+
+        /**
+         * @brief Exposes a property whose value is converted from a source
+         * property when it is read, instead of each time the source changes.
+         * When the source changes, the value is only marked stale and
+         * Invalidated is emitted, once until the value is read again. Reading
+         * a stale value runs the converter, so a lazy property must be read
+         * from one thread at a time.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam V The value type.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
+         */
+        template <typename Owner, typename V, detail::ThreadingPolicy Policy = thread_safe>
+        class lazy_property
+            : public detail::gettable_prop<lazy_property<Owner, V, Policy>> {
+            using my_type = lazy_property<Owner, V, Policy>;
+
+            template <typename, typename, typename>
+            friend class detail::lazy_binding_impl;
+            friend Owner;
+
+        public:
+            using value_type      = detail::traits::value_type<my_type>;
+            using const_reference = detail::traits::const_reference<my_type>;
+
+            /**
+             * @brief Emitted when the value becomes stale. Slots that need the
+             * new value can read the property, which converts it.
+             */
+            typename Policy::template signal<my_type> Invalidated;
+
+            lazy_property(
+                Owner* owner
+                )
+                : detail::gettable_prop<my_type>(owner)
+                , _value {}
+                {
+                }
+
+            lazy_property(
+                Owner*          owner,
+                const_reference v
+                )
+                : detail::gettable_prop<my_type>(owner)
+                , _value(v)
+                {
+                }
+
+            lazy_property(
+                lazy_property&& other
+                ) noexcept
+                : detail::gettable_prop<my_type>(std::move(other))
+                , Invalidated(std::move(other.Invalidated))
+                , _value(std::move(other._value))
+                , _binding(std::move(other._binding))
+                , _source(std::exchange(other._source, nullptr))
+                , _seen(other._seen)
+                , _pending(other._pending.load(std::memory_order_relaxed))
+                {
+                if (_source) _source->target = this;
+                }
+
+            lazy_property& operator=(
+                lazy_property&& other
+                ) noexcept
+                {
+                if (this == &other) return *this;
+                if (_binding) _binding->disconnect();
+                detail::gettable_prop<my_type>::operator=(std::move(other));
+                Invalidated = std::move(other.Invalidated);
+                _value      = std::move(other._value);
+                _binding    = std::move(other._binding);
+                _source     = std::exchange(other._source, nullptr);
+                _seen       = other._seen;
+                _pending.store(other._pending.load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+
+                if (_source) _source->target = this;
+                return *this;
+                }
+
+            ~lazy_property()
+                {
+                if (_binding) _binding->disconnect();
+                }
+
+            operator const_reference() const
+                {
+                return get();
+                }
+
+            /**
+             * @brief Checks whether the source has changed since the value
+             * was last converted.
+             */
+            bool stale() const
+                {
+                return _source && _source->stale(_seen);
+                }
+
+            /**
+             * @brief Binds this property to the value of another property. The
+             * value is read from the source when this property is next read.
+             * Once the binding is disconnected, the property keeps the last
+             * value read.
+             *
+             * @param src The source property.
+             *
+             * @return A handle to the binding.
+             */
+            template <typename PSrc>
+            requires detail::PropertyConvertible<PSrc, my_type>
+            std::shared_ptr<binding> bind(
+                detail::settable_prop<PSrc>& src
+                )
+                {
+                using binding_t = detail::lazy_binding_impl<PSrc, my_type>;
+                return attach(std::make_shared<binding_t>(this, &src), src.version());
+                }
+
+            /**
+             * @brief Binds this property to the value of another property
+             * using the given converter object, which runs when this property
+             * is read after the source has changed.
+             *
+             * @param src The source property.
+             * @param converter The converter object. Must be a functor that accepts
+             * a const reference to the source's value type and returns the target's
+             * value type.
+             *
+             * @return A handle to the binding.
+             */
+            template <typename PSrc, typename Converter>
+            requires detail::ValidConverter<PSrc, my_type, Converter>
+            std::shared_ptr<binding> bind(
+                detail::settable_prop<PSrc>& src,
+                Converter&&                  converter
+                )
+                {
+                using binding_t = detail::lazy_binding_impl<PSrc, my_type, Converter>;
+                return attach(std::make_shared<binding_t>(this, &src,
+                                                          std::forward<Converter>(converter)),
+                              src.version());
+                }
+
+            /**
+             * @brief Removes the binding from this property, if one exists.
+             * The property keeps the source's value as of the unbinding.
+             */
+            void unbind()
+                {
+                if (!_binding) return;
+                get();
+                _binding->disconnect();
+                _binding.reset();
+                _source = nullptr;
+                }
+
+        protected:
+            const_reference get() const override
+                {
+                if (_source) {
+                    // cleared first, so a change made during the conversion
+                    // is announced again
+                    _pending.store(false, std::memory_order_relaxed);
+                    _source->refresh(_value, _seen);
+                    }
+                return _value;
+                }
+
+        private:
+            template <typename Binding>
+            std::shared_ptr<binding> attach(
+                std::shared_ptr<Binding> b,
+                std::uint32_t            version
+                )
+                {
+                unbind();
+                _binding = b;
+                _source  = b.get();
+                // any version but the current one, so the first read converts
+                _seen    = version - 1;
+                invalidate();
+                return b;
+                }
+
+            void invalidate()
+                {
+                if (!_pending.exchange(true, std::memory_order_relaxed)) Invalidated();
+                }
+
+            mutable value_type _value;
+            std::shared_ptr<binding> _binding;
+            detail::lazy_source<my_type>* _source = nullptr;
+            mutable std::uint32_t _seen = 0;
+            mutable std::atomic<bool> _pending = false;
+        };
+        }
+    }
+#endif
@@ -0,0 +1,338 @@
+/*
+ * Persistent properties whose values live in a memory-mapped file. A
+ * trivially copyable layout struct is mapped directly, so restoring it
+ * costs a header check rather than a parse, and sets fire no Changed.
+ * Requires POSIX mmap.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_MAPPED_HPP
+#define MB_MEMPROP_MAPPED_HPP
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <memprop/snapshot.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief How a mapped_region obtained its values.
+         */
+        enum class mapped_status {
+            created,    ///< The file was new or empty, and holds the defaults.
+            restored,   ///< The values were restored from the file.
+            reset,      ///< The file held a different layout or was damaged, and was reset to the defaults.
+            unavailable ///< The file could not be mapped. Values are held in memory only.
+        };
+
+
+        namespace detail {
+            inline constexpr std::uint32_t mapped_magic   = 0x4D4D504D; // "MPMM"
+            inline constexpr std::uint16_t mapped_version = 1;
+
+            struct mapped_header {
+                std::uint32_t magic;
+                std::uint16_t version;
+                std::uint16_t reserved;
+                std::uint64_t schema;
+                std::uint64_t size;
+            };
+
+
+            // the layout starts on its own cache line after the header
+            inline constexpr std::size_t mapped_data_offset = 64;
+
+            /**
+             * @brief Hashes the size and alignment of a layout struct together
+             * with a caller-supplied name and schema version. Compiler type
+             * names are left out, as they differ between compilers and
+             * change when the struct is renamed or moved.
+             */
+            template <typename Layout>
+            constexpr std::uint64_t layout_hash(
+                std::string_view name,
+                std::uint32_t    schema
+                )
+                {
+                return hash_combine(name_hash(name, schema),
+                                    hash_combine(sizeof(Layout), alignof(Layout)));
+                }
+            }
+
+        template <typename Owner, auto Field>
+        class mapped_property;
+
+
+        /**
+         * @brief Maps a file holding one Layout value. The file starts with a
+         * header recording the layout's size and schema hash; if it does not
+         * match, the file is reset to the defaults. The schema hash covers the
+         * layout's size and alignment, an optional name, and the given schema
+         * version, which should be bumped whenever the fields of the layout
+         * change in a way the size and alignment do not reveal.
+         *
+         * Writes through mapped_property land in the page cache immediately,
+         * and are made durable by sync(), by sync_if_due(), or on destruction.
+         *
+         * @tparam Layout A trivially copyable struct of the persisted values.
+         */
+        template <typename Layout>
+        requires std::is_trivially_copyable_v<Layout>
+              && (alignof(Layout) <= detail::mapped_data_offset)
+        class mapped_region {
+            template <typename, auto>
+            friend class mapped_property;
+
+            static constexpr std::size_t _mappedSize = detail::mapped_data_offset + sizeof(Layout);
+
+            int _fd = -1;
+            std::byte* _map = nullptr;
+            std::unique_ptr<Layout> _memory;
+            Layout* _data = nullptr;
+            mapped_status _status = mapped_status::unavailable;
+            bool _dirty = false;
+            std::chrono::steady_clock::time_point _lastSync = std::chrono::steady_clock::now();
+
+            bool map(
+                std::filesystem::path const& path,
+                std::uint64_t                hash,
+                Layout const&                defaults
+                )
+                {
+                _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+                if (_fd < 0) return false;
+                struct stat st;
+
+                if (::fstat(_fd, &st) != 0) return false;
+                auto existing = static_cast<std::size_t>(st.st_size);
+
+                if (existing != _mappedSize && ::ftruncate(_fd, _mappedSize) != 0) return false;
+                void* p = ::mmap(nullptr, _mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+
+                if (p == MAP_FAILED) return false;
+                _map = static_cast<std::byte*>(p);
+                detail::mapped_header header;
+
+                std::memcpy(&header, _map, sizeof(header));
+                if (existing == _mappedSize && header.magic == detail::mapped_magic
+                    && header.version == detail::mapped_version && header.schema == hash
+                    && header.size == sizeof(Layout)) {
+                    _data   = std::launder(reinterpret_cast<Layout*>(_map + detail::mapped_data_offset));
+                    _status = mapped_status::restored;
+                    return true;
+                    }
+
+                // clear the magic first, so a crash part way leaves the file invalid
+                std::memset(_map, 0, sizeof(header));
+                _data   = new (_map + detail::mapped_data_offset) Layout(defaults);
+                ::msync(_map, _mappedSize, MS_SYNC);
+                header  = {detail::mapped_magic, detail::mapped_version, 0, hash, sizeof(Layout)};
+                std::memcpy(_map, &header, sizeof(header));
+                ::msync(_map, _mappedSize, MS_SYNC);
+                _status = existing ? mapped_status::reset : mapped_status::created;
+                return true;
+                }
+
+            void unmap()
+                {
+                if (_map) ::munmap(_map, _mappedSize);
+                if (_fd >= 0) ::close(_fd);
+                _map = nullptr;
+                _fd  = -1;
+                }
+
+        public:
+            using clock_type = std::chrono::steady_clock;
+
+            /**
+             * @brief Maps the given file, creating it if necessary.
+             *
+             * @param path The file to map.
+             * @param schema The schema version of the layout.
+             * @param defaults The values used when the file is created or reset.
+             */
+            mapped_region(
+                std::filesystem::path const& path,
+                std::uint32_t                schema,
+                Layout const&                defaults = Layout {}
+                )
+                : mapped_region(path, std::string_view(), schema, defaults)
+                {
+                }
+
+            /**
+             * @brief Maps the given file, creating it if necessary. The name
+             * identifies the layout, so a file written for a different layout
+             * of the same size is reset.
+             *
+             * @param path The file to map.
+             * @param name The name of the layout.
+             * @param schema The schema version of the layout.
+             * @param defaults The values used when the file is created or reset.
+             */
+            mapped_region(
+                std::filesystem::path const& path,
+                std::string_view             name,
+                std::uint32_t                schema,
+                Layout const&                defaults = Layout {}
+                )
+                {
+                if (!map(path, detail::layout_hash<Layout>(name, schema), defaults)) {
+                    unmap();
+                    _memory = std::make_unique<Layout>(defaults);
+                    _data   = _memory.get();
+                    _status = mapped_status::unavailable;
+                    }
+                }
+
+            mapped_region(mapped_region const&)            = delete;
+            mapped_region& operator=(mapped_region const&) = delete;
+
+            /**
+             * @brief Syncs any unsynced writes, and unmaps the file.
+             */
+            ~mapped_region()
+                {
+                sync();
+                unmap();
+                }
+
+            /**
+             * @brief Gets how the values were obtained.
+             */
+            mapped_status status() const
+                {
+                return _status;
+                }
+
+            /**
+             * @brief Gets the mapped values.
+             */
+            Layout const& data() const
+                {
+                return *_data;
+                }
+
+            /**
+             * @brief Checks whether values were written since the last sync.
+             */
+            bool dirty() const
+                {
+                return _dirty;
+                }
+
+            /**
+             * @brief Writes the mapped values back to the file.
+             *
+             * @param wait If true, returns once the values are on disk;
+             * otherwise only schedules the write.
+             *
+             * @return False if the write could not be made or scheduled.
+             */
+            bool sync(
+                bool wait = true
+                )
+                {
+                if (!_dirty) return true;
+                if (_map && ::msync(_map, _mappedSize, wait ? MS_SYNC : MS_ASYNC) != 0) return false;
+                _dirty    = false;
+                _lastSync = clock_type::now();
+                return true;
+                }
+
+            /**
+             * @brief Schedules a write back of the mapped values if any were
+             * written and the given interval has passed since the last sync.
+             * Meant to be called periodically, for example once per frame.
+             *
+             * @return True if a write back was scheduled.
+             */
+            bool sync_if_due(
+                clock_type::duration   interval,
+                clock_type::time_point now = clock_type::now()
+                )
+                {
+                if (!_dirty || now - _lastSync < interval) return false;
+                return sync(false);
+                }
+        };
+
+
+        namespace detail {
+            template <auto Field>
+            using mapped_layout = typename member_pointer_traits<decltype(Field)>::class_type;
+
+            template <typename Owner, auto Field>
+            struct property_traits<mapped_property<Owner, Field>> {
+                using owner_type      = Owner;
+                using property_type   = mapped_property<Owner, Field>;
+                using value_type      = typename member_pointer_traits<decltype(Field)>::member_type;
+                using const_reference = value_type const&;
+            };
+            }
+
+
+        /**
+         * @brief Exposes a public property whose value is a field of a
+         * mapped_region. Reads and writes go straight to the mapped file.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam Field A pointer to the field of the region's layout that
+         * holds the value.
+         */
+        template <typename Owner, auto Field>
+        class mapped_property
+            : public public_property_base<mapped_property<Owner, Field>> {
+            using my_type = mapped_property<Owner, Field>;
+
+            mapped_region<detail::mapped_layout<Field>>* _region;
+
+            friend Owner;
+        public:
+            using value_type      = detail::traits::value_type<my_type>;
+            using const_reference = detail::traits::const_reference<my_type>;
+            mapped_property(
+                Owner*                                       owner,
+                mapped_region<detail::mapped_layout<Field>>& region
+                )
+                : public_property_base<my_type>(owner)
+                , _region(&region)
+                {
+                }
+
+            my_type& operator=(
+                const_reference rhs
+                )
+                {
+                this->set(rhs);
+                return *this;
+                }
+
+        protected:
+            const_reference get() const override
+                {
+                return _region->_data->*Field;
+                }
+
+        private:
+            bool do_set(
+                const_reference v
+                ) override
+                {
+                _region->_data->*Field = v;
+                _region->_dirty        = true;
+                return true;
+                }
+        };
+        }
+    }
+#endif
@@ -7,17 +7,55 @@
 
 #ifndef MB_MEMPROP_HPP
 #define MB_MEMPROP_HPP
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <deque>
 #include <type_traits>
+#include <utility>
 #include <sigslot/signal.hpp>
+#include <memprop/notifier.hpp>
 
 namespace mousebyte {
     namespace memprop {
+        /**
+         * @brief Threading policy of properties that may be set and observed
+         * from several threads. Changed is a sigslot20 signal.
+         */
+        struct thread_safe {
+            template <typename Owner, typename... T>
+            using signal     = sigslot::signal_ix<Owner, T...>;
+            using connection = sigslot::connection;
+        };
+
+
+        /**
+         * @brief Threading policy of properties that are only used from one
+         * thread. Changed is an unsynchronized_signal, which connects and
+         * emits without locks or atomics.
+         */
+        struct single_threaded {
+            template <typename Owner, typename... T>
+            using signal     = unsynchronized_signal<Owner, T...>;
+            using connection = unsynchronized_connection;
+        };
+
+
+        namespace detail {
+            template <typename P>
+            concept ThreadingPolicy = requires {
+                typename P::connection;
+                typename P::template signal<P, int>;
+                };
+            }
+
+
         /**
          * @brief Provides access to a property binding.
          */
         class binding {
         protected:
-            sigslot::connection _connection;
             binding() = default;
 
         public:
@@ -32,27 +70,389 @@ namespace mousebyte {
              * @return True if the binding is active, false
              * if the binding has been disconnected.
              */
-            bool active() const
+            virtual bool active() const = 0;
+
+            /**
+             * @brief Disconnects the binding.
+             */
+            virtual void disconnect() = 0;
+
+            virtual ~binding() = default;
+        };
+
+
+        /**
+         * @brief Specifies which property provides the initial value
+         * of a two-way binding.
+         */
+        enum class sync_direction {
+            to_first,  ///< The first property takes the value of the second.
+            to_second, ///< The second property takes the value of the first.
+            none       ///< Neither property is updated until one of them is set.
+        };
+
+
+        /**
+         * @brief Identifies a settable property within its owner. Ids are only
+         * assigned for owners that opt into a feature that needs them, and
+         * are given in order of construction starting from zero.
+         */
+        using property_id = std::uint16_t;
+
+        class history_tracking;
+        class executor;
+
+
+        namespace detail {
+            template <typename>
+            class settable_prop;
+
+            /**
+             * @brief Hands out property ids to the properties of an owner.
+             */
+            class property_id_source {
+                property_id _nextPropertyId = 0;
+
+                // Takes the next id, for properties constructed on the owner.
+                friend property_id draw_property_id(
+                    property_id_source& ids
+                    )
+                    {
+                    return ids._nextPropertyId++;
+                    }
+
+            protected:
+                property_id_source() = default;
+                property_id_source(property_id_source&&)            = default;
+                property_id_source& operator=(property_id_source&&) = default;
+
+            public:
+                property_id_source(property_id_source const&)            = delete;
+                property_id_source& operator=(property_id_source const&) = delete;
+
+                /**
+                 * @brief Gets the number of ids handed out so far.
+                 */
+                property_id property_count() const
+                    {
+                    return _nextPropertyId;
+                    }
+            };
+
+            template <typename Owner>
+            concept HasPropertyIds = std::is_base_of_v<property_id_source, Owner>;
+            }
+
+
+        /**
+         * @brief Base class for owners that keep a dirty bit for each of their
+         * properties. A property's bit is set whenever it emits Changed, and
+         * can be polled and cleared in bulk, without connecting any slots.
+         *
+         * @tparam N The maximum number of properties tracked. Properties
+         * constructed after the first N are not tracked.
+         */
+        template <std::size_t N = 64>
+        class dirty_tracking
+            : public virtual detail::property_id_source {
+            template <typename>
+            friend class detail::settable_prop;
+            std::array<std::uint64_t, (N + 63) / 64> _dirty {};
+
+            void mark_dirty(
+                property_id id
+                )
+                {
+                if (id < N) _dirty[id / 64] |= std::uint64_t{1} << (id % 64);
+                }
+
+        protected:
+            dirty_tracking() = default;
+
+        public:
+            /**
+             * @brief Checks whether any property is dirty.
+             */
+            bool is_dirty() const
                 {
-                return _connection.connected();
+                for (auto w : _dirty) {
+                    if (w) return true;
+                    }
+                return false;
                 }
 
             /**
-             * @brief Disconnects the binding.
+             * @brief Checks whether the property with the given id is dirty.
+             */
+            bool is_dirty(
+                property_id id
+                ) const
+                {
+                return id < N && (_dirty[id / 64] >> (id % 64) & 1);
+                }
+
+            /**
+             * @brief Clears the dirty bit of every property.
+             */
+            void clear_dirty()
+                {
+                _dirty.fill(0);
+                }
+
+            /**
+             * @brief Invokes the given function with the id of each dirty
+             * property in ascending order, and clears the dirty bits. Properties
+             * set from within the function are marked dirty again.
+             *
+             * @param fn A functor accepting a property_id.
+             */
+            template <typename Fn>
+            requires std::invocable<Fn&, property_id>
+            void consume_dirty(
+                Fn&& fn
+                )
+                {
+                for (std::size_t w = 0; w < _dirty.size(); ++w) {
+                    auto bits = std::exchange(_dirty[w], 0);
+
+                    for (; bits; bits &= bits - 1) {
+                        fn(static_cast<property_id>(w * 64 + std::countr_zero(bits)));
+                        }
+                    }
+                }
+        };
+
+
+        namespace detail {
+            template <typename T>
+            inline constexpr char value_type_tag = 0;
+            }
+
+
+        /**
+         * @brief A type-erased reference to the new value of a property,
+         * passed to PropertyChanged. It is only valid during the emission.
+         */
+        class changed_value {
+            void const* _value;
+            char const* _type;
+
+        public:
+            template <typename T>
+            explicit changed_value(
+                T const& value
+                )
+                : _value(&value)
+                , _type(&detail::value_type_tag<T>)
+                {
+                }
+
+            /**
+             * @brief Checks whether the value is of type T.
+             */
+            template <typename T>
+            bool is() const
+                {
+                return _type == &detail::value_type_tag<T>;
+                }
+
+            /**
+             * @brief Gets a pointer to the value if it is of type T, or
+             * nullptr otherwise.
              */
-            void disconnect()
+            template <typename T>
+            T const* get_if() const
                 {
-                _connection.disconnect();
+                return is<T>() ? static_cast<T const*>(_value) : nullptr;
                 }
+        };
+
+
+        /**
+         * @brief Base class for owners that report a change of any of their
+         * properties through one signal, so observing every property of an
+         * owner takes a single connection. Only properties that emit Changed
+         * with their value are reported; flag groups and lazy properties are
+         * not.
+         *
+         * @tparam Policy The threading policy of PropertyChanged.
+         */
+        template <typename Policy = thread_safe>
+        class change_reporting
+            : public virtual detail::property_id_source {
+            template <typename>
+            friend class detail::settable_prop;
 
-            virtual ~binding()
+            void report_changed(
+                property_id   id,
+                changed_value value
+                )
                 {
-                disconnect();
+                PropertyChanged(id, value);
                 }
+
+        protected:
+            change_reporting() = default;
+
+        public:
+            /**
+             * @brief Emitted after a property emits Changed, with the id of
+             * the property and its new value.
+             */
+            typename Policy::template signal<change_reporting, property_id, changed_value> PropertyChanged;
+        };
+
+
+        namespace detail {
+            template <typename Policy>
+            void as_change_reporting(change_reporting<Policy>&);
+
+            template <typename Owner>
+            concept HasChangeReporting = requires(Owner& o) {
+                    detail::as_change_reporting(o);
+                };
+            }
+
+
+        /**
+         * @brief Base class for owners that can be moved, such as owners
+         * stored by value in a std::vector. Their properties can be moved
+         * along with them: each moved property finds its new owner at the
+         * same offset as before, and takes its Changed connections, waiters
+         * and bindings along.
+         *
+         * Slots that point at the owner itself, and history records or
+         * animations of its properties, still refer to the old address.
+         */
+        class relocatable {
+        protected:
+            relocatable() = default;
         };
 
 
         namespace detail {
+            template <typename Owner>
+            concept Relocatable = std::is_base_of_v<relocatable, Owner>;
+
+            template <typename Owner>
+            concept HasDirtyTracking = requires(Owner& o, property_id id) {
+                    { o.is_dirty(id) }->std::same_as<bool>;
+                    o.clear_dirty();
+                } && HasPropertyIds<Owner>;
+
+            template <typename Owner>
+            concept HasHistory = std::is_base_of_v<history_tracking, Owner>;
+
+            template <typename Owner>
+            concept HasStaticBindings = requires { typename Owner::static_bindings; };
+
+
+            /**
+             * @brief An intrusive list node for something waiting on the next
+             * change of a property. Nodes live in the waiter, so waiting needs
+             * no allocation and no slot connection.
+             */
+            struct change_waiter {
+                change_waiter* next   = nullptr;
+                change_waiter** link  = nullptr;
+                void (* notify)(change_waiter*, void const*) = nullptr;
+                // the property waited on, kept current if it is relocated
+                void* source = nullptr;
+            };
+
+
+            inline void link_waiter(
+                change_waiter*& head,
+                change_waiter&  w
+                )
+                {
+                w.next = head;
+                w.link = &head;
+                if (head) head->link = &w.next;
+                head = &w;
+                }
+
+            // The heads of the woken lists being walked on this thread, one
+            // per nested wake. Growing and shrinking at the back keeps the
+            // addresses of the heads in use valid.
+            inline std::deque<change_waiter*>& woken_heads()
+                {
+                static thread_local std::deque<change_waiter*> heads;
+                return heads;
+                }
+
+            inline void unlink_waiter(
+                change_waiter& w
+                )
+                {
+                if (!w.link) return;
+                *w.link = w.next;
+                if (w.next) w.next->link = w.link;
+                w.next = nullptr;
+                w.link = nullptr;
+                }
+
+            /**
+             * @brief Refers to a property for as long as it exists. Follows
+             * the property when it is relocated, and becomes null when it is
+             * destroyed. References are linked into the property they refer
+             * to, so they must be created and destroyed on the thread that
+             * uses the property.
+             */
+            template <typename Prop>
+            class property_ref {
+                friend class settable_prop<Prop>;
+                settable_prop<Prop>* _prop;
+                property_ref* _next   = nullptr;
+                property_ref** _link  = nullptr;
+
+                void unlink()
+                    {
+                    if (!_link) return;
+                    *_link = _next;
+                    if (_next) _next->_link = _link;
+                    _next = nullptr;
+                    _link = nullptr;
+                    }
+
+            public:
+                explicit property_ref(
+                    settable_prop<Prop>* prop
+                    )
+                    : _prop(prop)
+                    {
+                    auto& head = prop->_refs;
+
+                    _next = head;
+                    _link = &head;
+                    if (head) head->_link = &_next;
+                    head = this;
+                    }
+
+                property_ref(property_ref const&)            = delete;
+                property_ref& operator=(property_ref const&) = delete;
+
+                ~property_ref()
+                    {
+                    unlink();
+                    }
+
+                settable_prop<Prop>& operator*() const
+                    {
+                    return *_prop;
+                    }
+
+                settable_prop<Prop>* operator->() const
+                    {
+                    return _prop;
+                    }
+
+                explicit operator bool() const
+                    {
+                    return _prop != nullptr;
+                    }
+            };
+
             //member function helper aliases
 
             template <typename Owner, typename T>
@@ -66,25 +466,38 @@ namespace mousebyte {
 
             template <typename, typename, typename>
             class binding_impl;
+            template <typename, typename, typename, typename>
+            class two_way_binding_impl;
             template <typename>
             class core_binding_access;
+            template <typename>
+            class change_awaiter;
+            template <typename>
+            class change_stream;
+            struct property_access;
+            template <typename Owner>
+            struct static_propagation;
             }
 
         template <typename Owner, typename V, detail::mem_getter<Owner, V> Get>
         class computed_property;
         template <typename Owner, typename V,
-                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set>
+                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set,
+                  detail::ThreadingPolicy Policy>
         class public_property;
         template <typename Owner, typename V,
                   detail::mem_getter<Owner, std::remove_cvref_t<V> const&> Get,
-                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set>
+                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set,
+                  detail::ThreadingPolicy Policy>
         class backed_public_property;
         template <typename Owner, typename V,
-                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set>
+                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set,
+                  detail::ThreadingPolicy Policy>
         class readonly_property;
         template <typename Owner, typename V,
                   detail::mem_getter<Owner, std::remove_cvref_t<V> const&> Get,
-                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set>
+                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set,
+                  detail::ThreadingPolicy Policy>
         class backed_readonly_property;
 
         namespace detail {
@@ -204,62 +617,72 @@ namespace mousebyte {
 
 
             template <typename Owner, typename V,
-                      detail::mem_setter<Owner, std::remove_cvref_t<V>> Set>
-            struct property_traits<public_property<Owner, V, Set>> {
+                      detail::mem_setter<Owner, std::remove_cvref_t<V>> Set,
+                      detail::ThreadingPolicy Policy>
+            struct property_traits<public_property<Owner, V, Set, Policy>> {
                 using owner_type      = Owner;
-                using property_type   = public_property<Owner, V, Set>;
+                using property_type   = public_property<Owner, V, Set, Policy>;
                 using value_type      = std::remove_cvref_t<V>;
                 using const_reference = value_type const&;
+                using policy_type     = Policy;
             };
 
 
-            template <typename Owner, typename V>
-            struct property_traits<public_property<Owner, V, nullptr>> {
+            template <typename Owner, typename V, detail::ThreadingPolicy Policy>
+            struct property_traits<public_property<Owner, V, nullptr, Policy>> {
                 using owner_type      = Owner;
-                using property_type   = public_property<Owner, V, nullptr>;
+                using property_type   = public_property<Owner, V, nullptr, Policy>;
                 using value_type      = std::remove_cvref_t<V>;
                 using const_reference = value_type const&;
+                using policy_type     = Policy;
             };
 
 
             template <typename Owner, typename V,
-                      detail::mem_setter<Owner, std::remove_cvref_t<V>> Set>
-            struct property_traits<readonly_property<Owner, V, Set>> {
+                      detail::mem_setter<Owner, std::remove_cvref_t<V>> Set,
+                      detail::ThreadingPolicy Policy>
+            struct property_traits<readonly_property<Owner, V, Set, Policy>> {
                 using owner_type      = Owner;
-                using property_type   = readonly_property<Owner, V, Set>;
+                using property_type   = readonly_property<Owner, V, Set, Policy>;
                 using value_type      = std::remove_cvref_t<V>;
                 using const_reference = value_type const&;
+                using policy_type     = Policy;
             };
 
 
-            template <typename Owner, typename V>
-            struct property_traits<readonly_property<Owner, V, nullptr>> {
+            template <typename Owner, typename V, detail::ThreadingPolicy Policy>
+            struct property_traits<readonly_property<Owner, V, nullptr, Policy>> {
                 using owner_type      = Owner;
-                using property_type   = readonly_property<Owner, V, nullptr>;
+                using property_type   = readonly_property<Owner, V, nullptr, Policy>;
                 using value_type      = std::remove_cvref_t<V>;
                 using const_reference = value_type const&;
+                using policy_type     = Policy;
             };
 
 
             template <typename Owner, typename V,
                       detail::mem_getter<Owner, std::remove_cvref_t<V> const&> Get,
-                      detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set>
-            struct property_traits<backed_public_property<Owner, V, Get, Set>> {
+                      detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set,
+                      detail::ThreadingPolicy Policy>
+            struct property_traits<backed_public_property<Owner, V, Get, Set, Policy>> {
                 using owner_type      = Owner;
-                using property_type   = backed_public_property<Owner, V, Get, Set>;
+                using property_type   = backed_public_property<Owner, V, Get, Set, Policy>;
                 using value_type      = std::remove_cvref_t<V>;
                 using const_reference = value_type const&;
+                using policy_type     = Policy;
             };
 
 
             template <typename Owner, typename V,
                       detail::mem_getter<Owner, std::remove_cvref_t<V> const&> Get,
-                      detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set>
-            struct property_traits<backed_readonly_property<Owner, V, Get, Set>> {
+                      detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set,
+                      detail::ThreadingPolicy Policy>
+            struct property_traits<backed_readonly_property<Owner, V, Get, Set, Policy>> {
                 using owner_type      = Owner;
-                using property_type   = backed_readonly_property<Owner, V, Get, Set>;
+                using property_type   = backed_readonly_property<Owner, V, Get, Set, Policy>;
                 using value_type      = std::remove_cvref_t<V>;
                 using const_reference = value_type const&;
+                using policy_type     = Policy;
             };
 
 
@@ -276,6 +699,36 @@ namespace mousebyte {
                 template <typename P>
                 using const_reference =
                     typename property_traits<P>::const_reference;
+
+                template <typename P>
+                struct policy_of {
+                    using type = thread_safe;
+                };
+
+                template <typename P>
+                requires requires { typename property_traits<P>::policy_type; }
+                struct policy_of<P> {
+                    using type = typename property_traits<P>::policy_type;
+                };
+
+                // Property types that do not name a policy are thread-safe.
+                template <typename P>
+                using policy_type     = typename policy_of<P>::type;
+
+                template <typename P>
+                struct stable_values_of
+                    : std::true_type {};
+
+                template <typename P>
+                requires requires { property_traits<P>::stable_values; }
+                struct stable_values_of<P>
+                    : std::bool_constant<property_traits<P>::stable_values> {};
+
+                // Property types whose value may move while Changed is
+                // emitted, such as a value in a vector that a slot can grow,
+                // declare stable_values = false, and slots get a copy.
+                template <typename P>
+                inline constexpr bool stable_values = stable_values_of<P>::value;
                 }
 
             class dummy_converter { };
@@ -293,12 +746,18 @@ namespace mousebyte {
 
             template <typename Prop>
             class gettable_prop {
+                friend struct property_access;
                 using owner_type      = detail::traits::owner_type<Prop>;
                 owner_type* _owner;
 
             protected:
                 using const_reference = detail::traits::const_reference<Prop>;
 
+                owner_type* owner() const
+                    {
+                    return _owner;
+                    }
+
                 template <auto Pmf, typename ... Args>
                 requires requires(
                     owner_type* p,
@@ -334,11 +793,34 @@ namespace mousebyte {
                     {
                     }
 
+                // A relocated property finds its owner at the same offset as
+                // before. A property assigned to keeps its owner. Checked when
+                // used rather than constrained, as the owner is incomplete
+                // while its properties are declared.
+                gettable_prop(
+                    gettable_prop&& other
+                    ) noexcept
+                    : _owner(reinterpret_cast<owner_type*>(
+                                 reinterpret_cast<char*>(this)
+                                 - (reinterpret_cast<char const*>(&other)
+                                    - reinterpret_cast<char const*>(other._owner))))
+                    {
+                    static_assert(Relocatable<owner_type>,
+                                  "Properties can only be moved along with an owner derived from relocatable.");
+                    }
+
+                gettable_prop& operator=(
+                    gettable_prop&&
+                    ) noexcept
+                    {
+                    static_assert(Relocatable<owner_type>,
+                                  "Properties can only be moved along with an owner derived from relocatable.");
+                    return *this;
+                    }
+
             public:
                 gettable_prop(gettable_prop const&)            = delete;
-                gettable_prop(gettable_prop&&)                 = delete;
                 gettable_prop& operator=(gettable_prop const&) = delete;
-                gettable_prop& operator=(gettable_prop&&)      = delete;
 
                 virtual ~gettable_prop() = default;
 
@@ -541,27 +1023,120 @@ namespace mousebyte {
             protected:
                 template <typename, typename, typename>
                 friend class binding_impl;
+                template <typename, typename, typename, typename>
+                friend class two_way_binding_impl;
+                friend struct property_access;
+                friend class property_ref<Prop>;
 
                 using const_reference = detail::traits::const_reference<Prop>;
+                using owner_type      = detail::traits::owner_type<Prop>;
 
                 settable_prop(
-                    detail::traits::owner_type<Prop>* owner
+                    owner_type* owner
+                    )
+                    : gettable_prop<Prop>(owner)
+                    {
+                    if constexpr (HasPropertyIds<owner_type>) {
+                        _id = draw_property_id(static_cast<property_id_source&>(*owner));
+                        }
+                    }
+
+                // For properties created after their owner, which keep an id
+                // drawn in construction order on their behalf.
+                settable_prop(
+                    owner_type* owner,
+                    property_id id
                     )
                     : gettable_prop<Prop>(owner)
+                    , _id(id)
+                    {
+                    }
+
+                settable_prop(
+                    settable_prop&& other
+                    ) noexcept
+                    : gettable_prop<Prop>(std::move(other))
+                    , Changed(std::move(other.Changed))
+                    , _waiters(std::exchange(other._waiters, nullptr))
+                    , _refs(std::exchange(other._refs, nullptr))
+                    , _id(other._id)
+                    , _version(other.version())
+                    {
+                    adopt_links();
+                    }
+
+                // Waiters and bindings of the property assigned to are
+                // dropped, as if it had been destroyed.
+                settable_prop& operator=(
+                    settable_prop&& other
+                    ) noexcept
                     {
+                    if (this == &other) return *this;
+                    release_links();
+                    gettable_prop<Prop>::operator=(std::move(other));
+                    Changed  = std::move(other.Changed);
+                    _waiters = std::exchange(other._waiters, nullptr);
+                    _refs    = std::exchange(other._refs, nullptr);
+                    _id      = other._id;
+                    _version.store(other.version(), std::memory_order_relaxed);
+                    adopt_links();
+                    return *this;
+                    }
+
+                // Records a change of the value without emitting anything, so
+                // versions and dirty bits also cover silent sets.
+                void mark_changed()
+                    {
+                    _version.fetch_add(1, std::memory_order_relaxed);
+
+                    if constexpr (HasDirtyTracking<owner_type>) {
+                        this->owner()->mark_dirty(_id);
+                        }
                     }
 
                 void invoke_changed(
                     const_reference v
                     )
                     {
+                    if constexpr (!traits::stable_values<Prop>) {
+                        traits::value_type<Prop> const copy = v;
+
+                        emit_changed(copy);
+                        } else {
+                        emit_changed(v);
+                        }
+                    }
+
+                void emit_changed(
+                    const_reference v
+                    )
+                    {
+                    mark_changed();
                     Changed(v);
+
+                    if constexpr (HasChangeReporting<owner_type>) {
+                        this->owner()->report_changed(_id, changed_value(v));
+                        }
+                    if (_waiters) wake_waiters(v);
+                    if constexpr (HasStaticBindings<owner_type>) {
+                        static_propagation<owner_type>::changed(*this->owner(), *this);
+                        }
                     }
 
                 bool set(
                     const_reference v
                     )
                     {
+                    if constexpr (HasHistory<owner_type>) {
+                        if (auto history = this->owner()->history(); history && history->recording()) {
+                            traits::value_type<Prop> old = this->get();
+
+                            if (!do_set(v)) return false;
+                            history->record(*this->owner(), *this, old, this->get());
+                            invoke_changed(this->get());
+                            return true;
+                            }
+                        }
                     auto success = do_set(v);
 
                     if (success) {
@@ -571,18 +1146,255 @@ namespace mousebyte {
                     }
 
             public:
-                sigslot::signal_ix<settable_prop<Prop>, const_reference> Changed;
+                typename traits::policy_type<Prop>::template signal<settable_prop<Prop>, const_reference> Changed;
+
+                ~settable_prop()
+                    {
+                    release_links();
+                    }
+
+                /**
+                 * @brief Gets an awaitable that completes with the next value
+                 * of this property. Requires memprop/coro.hpp.
+                 *
+                 * @param e The executor to resume the awaiting coroutine on. If
+                 * null, it is resumed from within the setter.
+                 */
+                change_awaiter<Prop> next_change(
+                    executor* e = nullptr
+                    )
+                    {
+                    return change_awaiter<Prop>(*this, e);
+                    }
+
+                /**
+                 * @brief Gets a stream of this property's changes, whose
+                 * next() can be awaited repeatedly. Requires memprop/coro.hpp.
+                 *
+                 * @param e The executor to resume the awaiting coroutine on. If
+                 * null, it is resumed from within the setter.
+                 */
+                change_stream<Prop> changes(
+                    executor* e = nullptr
+                    )
+                    {
+                    return change_stream<Prop>(*this, e);
+                    }
+
+                /**
+                 * @brief Gets the id of this property within its owner. Always
+                 * zero if the owner does not assign property ids.
+                 */
+                property_id id() const
+                    {
+                    return _id;
+                    }
+
+                /**
+                 * @brief Gets a counter that advances each time this property
+                 * is set, silently or not, or emits Changed. Two equal versions
+                 * of a property imply an unchanged value, without comparing
+                 * values.
+                 */
+                std::uint32_t version() const
+                    {
+                    return _version.load(std::memory_order_relaxed);
+                    }
 
             private:
                 virtual bool do_set(const_reference) = 0;
+
+                // Points the waiters and references taken over from another
+                // property at this one.
+                void adopt_links()
+                    {
+                    if (_waiters) _waiters->link = &_waiters;
+                    for (auto w = _waiters; w; w = w->next) w->source = this;
+
+                    if (_refs) _refs->_link = &_refs;
+                    for (auto r = _refs; r; r = r->_next) r->_prop = this;
+                    }
+
+                void release_links()
+                    {
+                    while (_waiters) unlink_waiter(*_waiters);
+                    while (_refs) {
+                        _refs->_prop = nullptr;
+                        _refs->unlink();
+                        }
+                    }
+
+                // Wakes the waiters registered before this change. Waiters
+                // that register again while being woken wait for the next one.
+                // The head of the woken list is kept in woken_heads() while it
+                // is walked, and if a waiter throws, the rest go back to
+                // waiting. Either way the list is empty and its head released
+                // before returning, so no waiter is left pointing at it.
+                void wake_waiters(
+                    const_reference v
+                    )
+                    {
+                    struct woken_list {
+                        std::deque<change_waiter*>& heads;
+                        change_waiter*& waiters;
+                        change_waiter*& head = heads.emplace_back(std::exchange(waiters, nullptr));
+
+                        ~woken_list()
+                            {
+                            while (head) {
+                                auto& w = *head;
+
+                                unlink_waiter(w);
+                                link_waiter(waiters, w);
+                                }
+                            heads.pop_back();
+                            }
+                    } woken {woken_heads(), _waiters};
+
+                    woken.head->link = &woken.head;
+                    while (woken.head) {
+                        auto& w = *woken.head;
+
+                        unlink_waiter(w);
+                        w.notify(&w, &v);
+                        }
+                    }
+
+                change_waiter* _waiters = nullptr;
+                property_ref<Prop>* _refs = nullptr;
+                property_id _id = 0;
+                std::atomic<std::uint32_t> _version = 0;
+            };
+
+
+            /**
+             * @brief Marks a binding as propagating a change on the current
+             * thread, for as long as the frame exists. Frames form a stack per
+             * thread, so a binding can tell when a change it propagates comes
+             * back around to it, without touching any state shared with other
+             * threads.
+             */
+            class propagation_frame {
+                static inline thread_local propagation_frame* _top = nullptr;
+
+                void const* _binding;
+                propagation_frame* _previous;
+
+            public:
+                explicit propagation_frame(
+                    void const* binding
+                    )
+                    : _binding(binding)
+                    , _previous(std::exchange(_top, this))
+                    {
+                    }
+
+                propagation_frame(propagation_frame const&)            = delete;
+                propagation_frame& operator=(propagation_frame const&) = delete;
+
+                ~propagation_frame()
+                    {
+                    _top = _previous;
+                    }
+
+                /**
+                 * @brief Checks whether the given binding is propagating a
+                 * change on the current thread.
+                 */
+                static bool active(
+                    void const* binding
+                    )
+                    {
+                    for (auto f = _top; f; f = f->_previous) {
+                        if (f->_binding == binding) return true;
+                        }
+                    return false;
+                    }
+            };
+
+
+            /**
+             * @brief Marks a property as being set to a value it held before,
+             * by a silent set, an undo or redo, or a snapshot restore, on the
+             * current thread. Properties that announce or refuse changes take
+             * the mark when they store the value, and store it without doing
+             * so.
+             */
+            class replay_frame {
+                static inline thread_local replay_frame* _top = nullptr;
+
+                void const* _property;
+                replay_frame* _previous;
+
+            public:
+                explicit replay_frame(
+                    void const* property
+                    )
+                    : _property(property)
+                    , _previous(std::exchange(_top, this))
+                    {
+                    }
+
+                replay_frame(replay_frame const&)            = delete;
+                replay_frame& operator=(replay_frame const&) = delete;
+
+                ~replay_frame()
+                    {
+                    _top = _previous;
+                    }
+
+                /**
+                 * @brief Checks whether the given property is being replayed
+                 * on the current thread, and ends the replay, so that sets
+                 * made by slots of its Changed signal are not replays.
+                 */
+                static bool take(
+                    void const* property
+                    )
+                    {
+                    for (auto f = _top; f; f = f->_previous) {
+                        if (f->_property == property) {
+                            f->_property = nullptr;
+                            return true;
+                            }
+                        }
+                    return false;
+                    }
+            };
+
+
+            /**
+             * @brief A binding that holds a connection of the given type,
+             * which depends on the threading policy of the property observed.
+             */
+            template <typename Connection>
+            class basic_binding
+                : public binding {
+            protected:
+                Connection _connection;
+
+            public:
+                bool active() const override
+                    {
+                    return _connection.connected();
+                    }
+
+                void disconnect() override
+                    {
+                    _connection.disconnect();
+                    }
+
+                ~basic_binding() override
+                    {
+                    _connection.disconnect();
+                    }
             };
 
 
             template <typename PSrc, typename PTarget, typename Converter = detail::dummy_converter>
             class binding_impl
-                : public binding {
-                settable_prop<PSrc>* _source;
-                settable_prop<PTarget>* _target;
+                : public basic_binding<typename traits::policy_type<PSrc>::connection> {
+                property_ref<PTarget> _target;
                 Converter _converter;
 
                 template <typename>
@@ -591,6 +1403,7 @@ namespace mousebyte {
                     detail::traits::const_reference<PSrc> v
                     )
                     {
+                    if (!_target) return;
                     if constexpr (!std::same_as<Converter, detail::dummy_converter>) {
                         _target->set(_converter(v));
                         } else {
@@ -602,15 +1415,17 @@ namespace mousebyte {
                     detail::traits::const_reference<PSrc> v
                     )
                     {
-                    _connection.block();
+                    if (propagation_frame::active(this)) return;
+                    propagation_frame frame(this);
                     set_target_value(v);
-                    _connection.unblock();
                     }
 
-                void init()
+                void init(
+                    settable_prop<PSrc>* src
+                    )
                     {
-                    set_target_value(_source->get());
-                    _connection = _source->Changed
+                    set_target_value(src->get());
+                    this->_connection = src->Changed
                                   .connect(&binding_impl<PSrc, PTarget, Converter>::on_changed,
                                            this);
                     }
@@ -619,10 +1434,9 @@ namespace mousebyte {
                     settable_prop<PSrc>*    src,
                     settable_prop<PTarget>* target
                     )
-                    : _source(src)
-                    , _target(target)
+                    : _target(target)
                     {
-                    init();
+                    init(src);
                     }
 
                 binding_impl(
@@ -630,11 +1444,107 @@ namespace mousebyte {
                     settable_prop<PTarget>* target,
                     Converter&&             converter
                     )
-                    : _source(src)
-                    , _target(target)
+                    : _target(target)
                     , _converter(std::forward<Converter>(converter))
                     {
-                    init();
+                    init(src);
+                    }
+            };
+
+
+            template <typename PFirst, typename PSecond,
+                      typename Forward  = detail::dummy_converter,
+                      typename Backward = detail::dummy_converter>
+            class two_way_binding_impl
+                : public basic_binding<typename traits::policy_type<PFirst>::connection> {
+                property_ref<PFirst> _first;
+                property_ref<PSecond> _second;
+                Forward _forward;
+                Backward _backward;
+                typename traits::policy_type<PSecond>::connection _backConnection;
+
+                void set_second_value(
+                    detail::traits::const_reference<PFirst> v
+                    )
+                    {
+                    if (!_second) return;
+                    if constexpr (!std::same_as<Forward, detail::dummy_converter>) {
+                        _second->set(_forward(v));
+                        } else {
+                        _second->set(v);
+                        }
+                    }
+
+                void set_first_value(
+                    detail::traits::const_reference<PSecond> v
+                    )
+                    {
+                    if (!_first) return;
+                    if constexpr (!std::same_as<Backward, detail::dummy_converter>) {
+                        _first->set(_backward(v));
+                        } else {
+                        _first->set(v);
+                        }
+                    }
+
+                void on_first_changed(
+                    detail::traits::const_reference<PFirst> v
+                    )
+                    {
+                    if (propagation_frame::active(this) || !_backConnection.connected()) return;
+                    propagation_frame frame(this);
+                    set_second_value(v);
+                    }
+
+                void on_second_changed(
+                    detail::traits::const_reference<PSecond> v
+                    )
+                    {
+                    if (propagation_frame::active(this) || !this->_connection.connected()) return;
+                    propagation_frame frame(this);
+                    set_first_value(v);
+                    }
+
+            public:
+                two_way_binding_impl(
+                    settable_prop<PFirst>*  first,
+                    settable_prop<PSecond>* second,
+                    sync_direction          direction,
+                    Forward&&               forward  = Forward{},
+                    Backward&&              backward = Backward{}
+                    )
+                    : _first(first)
+                    , _second(second)
+                    , _forward(std::forward<Forward>(forward))
+                    , _backward(std::forward<Backward>(backward))
+                    {
+                    propagation_frame frame(this);
+
+                    if (direction == sync_direction::to_first) {
+                        set_first_value(_second->get());
+                        } else if (direction == sync_direction::to_second) {
+                        set_second_value(_first->get());
+                        }
+                    this->_connection = _first->Changed
+                                        .connect(&two_way_binding_impl::on_first_changed, this);
+                    _backConnection   = _second->Changed
+                                        .connect(&two_way_binding_impl::on_second_changed, this);
+                    }
+
+                ~two_way_binding_impl() override
+                    {
+                    _backConnection.disconnect();
+                    }
+
+                bool active() const override
+                    {
+                    return this->_connection.connected() && _backConnection.connected();
+                    }
+
+                void disconnect() override
+                    {
+                    this->_connection.disconnect();
+                    _backConnection.disconnect();
                     }
             };
 
@@ -652,6 +1562,27 @@ namespace mousebyte {
                     {
                     }
 
+                core_binding_access(
+                    detail::traits::owner_type<Prop>* owner,
+                    property_id                       id
+                    )
+                    : settable_prop<Prop>(owner, id)
+                    {
+                    }
+
+                core_binding_access(core_binding_access&&) = default;
+
+                core_binding_access& operator=(
+                    core_binding_access&& other
+                    ) noexcept
+                    {
+                    if (this == &other) return *this;
+                    reset_binding();
+                    settable_prop<Prop>::operator=(std::move(other));
+                    _binding = std::move(other._binding);
+                    return *this;
+                    }
+
                 template <typename PSrc>
                 std::shared_ptr<binding> bind_internal(
                     settable_prop<PSrc>* src
@@ -684,6 +1615,89 @@ namespace mousebyte {
                         }
                     }
             };
+
+
+            /**
+             * @brief Gives memprop's own facilities access to the protected
+             * interface of any property, regardless of its access level.
+             */
+            struct property_access {
+                template <typename Prop>
+                static traits::const_reference<Prop> get(
+                    gettable_prop<Prop> const& p
+                    )
+                    {
+                    return p.get();
+                    }
+
+                template <typename Prop>
+                static bool set(
+                    settable_prop<Prop>&          p,
+                    traits::const_reference<Prop> v
+                    )
+                    {
+                    return p.set(v);
+                    }
+
+                /**
+                 * @brief Gets the head of a property's list of change waiters.
+                 */
+                template <typename Prop>
+                static change_waiter*& waiters(
+                    settable_prop<Prop>& p
+                    )
+                    {
+                    return p._waiters;
+                    }
+
+                /**
+                 * @brief Sets the value of a property without emitting Changed.
+                 * The version of the property still advances, and its dirty bit
+                 * is set. The set is a replay, which cannot be vetoed.
+                 */
+                template <typename Prop>
+                static bool set_silent(
+                    settable_prop<Prop>&          p,
+                    traits::const_reference<Prop> v
+                    )
+                    {
+                    replay_frame frame(&p);
+
+                    if (!p.do_set(v)) return false;
+                    p.mark_changed();
+                    return true;
+                    }
+
+                /**
+                 * @brief Sets the value of a property and emits Changed, as a
+                 * replay of a value it held before, which cannot be vetoed.
+                 */
+                template <typename Prop>
+                static bool replay(
+                    settable_prop<Prop>&          p,
+                    traits::const_reference<Prop> v
+                    )
+                    {
+                    replay_frame frame(&p);
+                    return p.set(v);
+                    }
+
+                /**
+                 * @brief Emits Changed with the current value of a property.
+                 */
+                template <typename Prop>
+                static void notify(
+                    settable_prop<Prop>& p
+                    )
+                    {
+                    p.invoke_changed(p.get());
+                    }
+            };
+
+
+            template <typename P>
+            concept SettableProperty = std::derived_from<
+                P, settable_prop<traits::property_type<P>>>;
             } // namespace detail
 
 
@@ -732,6 +1746,14 @@ namespace mousebyte {
                 {
                 }
 
+            public_property_base(
+                detail::traits::owner_type<Prop>* owner,
+                property_id                       id
+                )
+                : detail::core_binding_access<Prop>(owner, id)
+                {
+                }
+
         public:
             using value_type      = detail::traits::value_type<my_type>;
             using const_reference = detail::traits::const_reference<my_type>;
@@ -897,18 +1919,75 @@ namespace mousebyte {
         };
 
 
+        /**
+         * @brief Binds two properties to each other, so that setting either one
+         * updates the other. Unlike a pair of calls to bind(), the two-way binding
+         * does not occupy the binding slot of either property, and remains active
+         * only for as long as the returned handle is held.
+         *
+         * @param first The first property.
+         * @param second The second property.
+         * @param direction Which property provides the initial value.
+         *
+         * @return A handle to the binding.
+         */
+        template <typename PFirst, typename PSecond>
+        requires detail::PropertyConvertible<PFirst, PSecond>
+              && detail::PropertyConvertible<PSecond, PFirst>
+        std::shared_ptr<binding> bind_two_way(
+            public_property_base<PFirst>&  first,
+            public_property_base<PSecond>& second,
+            sync_direction                 direction = sync_direction::to_first
+            )
+            {
+            using binding_t = detail::two_way_binding_impl<PFirst, PSecond>;
+            return std::make_shared<binding_t>(&first, &second, direction);
+            }
+
+        /**
+         * @brief Binds two properties to each other using a pair of converter
+         * objects.
+         *
+         * @param first The first property.
+         * @param second The second property.
+         * @param forward Converts the value of first to the value type of second.
+         * @param backward Converts the value of second to the value type of first.
+         * @param direction Which property provides the initial value.
+         *
+         * @return A handle to the binding.
+         */
+        template <typename PFirst, typename PSecond, typename Forward, typename Backward>
+        requires detail::ValidConverter<PFirst, PSecond, Forward>
+              && detail::ValidConverter<PSecond, PFirst, Backward>
+        std::shared_ptr<binding> bind_two_way(
+            public_property_base<PFirst>&  first,
+            public_property_base<PSecond>& second,
+            Forward&&                      forward,
+            Backward&&                     backward,
+            sync_direction                 direction = sync_direction::to_first
+            )
+            {
+            using binding_t = detail::two_way_binding_impl<PFirst, PSecond, Forward, Backward>;
+            return std::make_shared<binding_t>(&first, &second, direction,
+                                               std::forward<Forward>(forward),
+                                               std::forward<Backward>(backward));
+            }
+
+
         /**
          * @brief Exposes a property with a public getter and setter.
          *
          * @tparam Owner The type that contains the property.
          * @tparam V The value type.
          * @tparam Set A pointer to the member function of Owner to use as a setter.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
          */
         template <typename Owner, typename V,
-                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set = nullptr>
+                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set = nullptr,
+                  detail::ThreadingPolicy Policy = thread_safe>
         class public_property
-            : public public_property_base<public_property<Owner, V, Set>> {
-            using my_type         = public_property<Owner, V, Set>;
+            : public public_property_base<public_property<Owner, V, Set, Policy>> {
+            using my_type         = public_property<Owner, V, Set, Policy>;
 
             friend Owner;
         public:
@@ -974,13 +2053,15 @@ namespace mousebyte {
          * @tparam V The value type.
          * @tparam Get A pointer to the member function of Owner that gets the value.
          * @tparam Set A pointer to the member function of Owner that sets the value.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
          */
         template <typename Owner, typename V,
                   detail::mem_getter<Owner, std::remove_cvref_t<V> const&> Get,
-                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set>
+                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set,
+                  detail::ThreadingPolicy Policy = thread_safe>
         class backed_public_property
-            : public public_property_base<backed_public_property<Owner, V, Get, Set>> {
-            using my_type         = backed_public_property<Owner, V, Get, Set>;
+            : public public_property_base<backed_public_property<Owner, V, Get, Set, Policy>> {
+            using my_type         = backed_public_property<Owner, V, Get, Set, Policy>;
             friend Owner;
         public:
             using value_type      = detail::traits::value_type<my_type>;
@@ -1035,6 +2116,14 @@ namespace mousebyte {
                 {
                 }
 
+            readonly_property_base(
+                detail::traits::owner_type<Prop>* owner,
+                property_id                       id
+                )
+                : detail::core_binding_access<Prop>(owner, id)
+                {
+                }
+
             /**
              * @brief Removes the binding from this property, if one exists.
              */
@@ -1177,12 +2266,14 @@ namespace mousebyte {
          * @tparam Owner The type that contains the property.
          * @tparam V The value type.
          * @tparam Set A pointer to the member function of Owner to use as a setter.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
          */
         template <typename Owner, typename V,
-                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set = nullptr>
+                  detail::mem_setter<Owner, std::remove_cvref_t<V>> Set = nullptr,
+                  detail::ThreadingPolicy Policy = thread_safe>
         class readonly_property
-            : public readonly_property_base<readonly_property<Owner, V, Set>> {
-            using my_type         = readonly_property<Owner, V, Set>;
+            : public readonly_property_base<readonly_property<Owner, V, Set, Policy>> {
+            using my_type         = readonly_property<Owner, V, Set, Policy>;
 
             friend Owner;
         public:
@@ -1248,13 +2339,15 @@ namespace mousebyte {
          * @tparam V The value type.
          * @tparam Get A pointer to the member function of Owner that gets the value.
          * @tparam Set A pointer to the member function of Owner that sets the value.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
          */
         template <typename Owner, typename V,
                   detail::mem_getter<Owner, std::remove_cvref_t<V> const&> Get,
-                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set>
+                  detail::mem_setter_backed<Owner, std::remove_cvref_t<V>> Set,
+                  detail::ThreadingPolicy Policy = thread_safe>
         class backed_readonly_property
-            : public readonly_property_base<backed_readonly_property<Owner, V, Get, Set>> {
-            using my_type         = backed_readonly_property<Owner, V, Get, Set>;
+            : public readonly_property_base<backed_readonly_property<Owner, V, Get, Set, Policy>> {
+            using my_type         = backed_readonly_property<Owner, V, Get, Set, Policy>;
             friend Owner;
         public:
             using value_type      = detail::traits::value_type<my_type>;
@@ -0,0 +1,352 @@
+/*
+ * A signal for objects that are only used from one thread. It provides the
+ * parts of the sigslot20 interface used by properties, without locks,
+ * atomics or atomic reference counting.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_NOTIFIER_HPP
+#define MB_MEMPROP_NOTIFIER_HPP
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mousebyte {
+    namespace memprop {
+        namespace detail {
+            // Shared by a signal and the connections to one of its slots, and
+            // freed by whichever lets go of it last. While the signal holds the
+            // slot, stale points to the flag telling it to drop disconnected
+            // slots.
+            struct unsynchronized_slot_state {
+                std::size_t refs = 1;
+                bool* stale      = nullptr;
+                bool connected   = true;
+                bool blocked     = false;
+
+                virtual ~unsynchronized_slot_state() = default;
+            };
+
+
+            inline void release(
+                unsynchronized_slot_state* s
+                )
+                {
+                if (s && --s->refs == 0) delete s;
+                }
+            }
+
+        template <typename, typename...>
+        class unsynchronized_signal;
+
+
+        /**
+         * @brief A handle to a slot of an unsynchronized_signal. Mirrors
+         * sigslot::connection, and remains safe to use after the signal is
+         * destroyed.
+         */
+        class unsynchronized_connection {
+            template <typename, typename...>
+            friend class unsynchronized_signal;
+
+        protected:
+            detail::unsynchronized_slot_state* _state = nullptr;
+
+            explicit unsynchronized_connection(
+                detail::unsynchronized_slot_state* state
+                )
+                : _state(state)
+                {
+                ++_state->refs;
+                }
+
+        public:
+            unsynchronized_connection() = default;
+
+            unsynchronized_connection(
+                unsynchronized_connection const& other
+                )
+                : _state(other._state)
+                {
+                if (_state) ++_state->refs;
+                }
+
+            unsynchronized_connection(
+                unsynchronized_connection&& other
+                ) noexcept
+                : _state(std::exchange(other._state, nullptr))
+                {
+                }
+
+            unsynchronized_connection& operator=(
+                unsynchronized_connection other
+                ) noexcept
+                {
+                std::swap(_state, other._state);
+                return *this;
+                }
+
+            ~unsynchronized_connection()
+                {
+                detail::release(_state);
+                }
+
+            /**
+             * @brief Checks whether the handle refers to a slot.
+             */
+            bool valid() const
+                {
+                return _state;
+                }
+
+            /**
+             * @brief Checks whether the slot is still connected.
+             */
+            bool connected() const
+                {
+                return _state && _state->connected;
+                }
+
+            /**
+             * @brief Disconnects the slot.
+             *
+             * @return False if the slot was already disconnected.
+             */
+            bool disconnect()
+                {
+                if (!connected()) return false;
+                _state->connected = false;
+                if (_state->stale) *_state->stale = true;
+                return true;
+                }
+
+            bool blocked() const
+                {
+                return _state && _state->blocked;
+                }
+
+            void block()
+                {
+                if (_state) _state->blocked = true;
+                }
+
+            void unblock()
+                {
+                if (_state) _state->blocked = false;
+                }
+        };
+
+
+        /**
+         * @brief An unsynchronized_connection that disconnects its slot when
+         * destroyed. Mirrors sigslot::scoped_connection.
+         */
+        class unsynchronized_scoped_connection
+            : public unsynchronized_connection {
+        public:
+            unsynchronized_scoped_connection() = default;
+
+            unsynchronized_scoped_connection(
+                unsynchronized_connection c
+                )
+                : unsynchronized_connection(std::move(c))
+                {
+                }
+
+            unsynchronized_scoped_connection(unsynchronized_scoped_connection const&)            = delete;
+            unsynchronized_scoped_connection& operator=(unsynchronized_scoped_connection const&) = delete;
+
+            unsynchronized_scoped_connection(unsynchronized_scoped_connection&&) noexcept = default;
+
+            unsynchronized_scoped_connection& operator=(
+                unsynchronized_scoped_connection&& other
+                ) noexcept
+                {
+                disconnect();
+                unsynchronized_connection::operator=(std::move(other));
+                return *this;
+                }
+
+            ~unsynchronized_scoped_connection()
+                {
+                disconnect();
+                }
+        };
+
+
+        /**
+         * @brief A signal that can only be emitted by Owner, for use from a
+         * single thread. Slots may connect or disconnect, and the signal may be
+         * emitted again, from within a slot. Slots connected during an emission
+         * are first called by the next one.
+         *
+         * @tparam Owner The type allowed to emit the signal.
+         * @tparam T The argument types of the slots.
+         */
+        template <typename Owner, typename... T>
+        class unsynchronized_signal {
+            struct slot
+                : detail::unsynchronized_slot_state {
+                std::function<void(T...)> fn;
+            };
+
+
+            std::vector<slot*> _slots;
+            std::size_t _emitting = 0;
+            bool _stale   = false;
+            bool _blocked = false;
+
+            friend Owner;
+
+            // Drops disconnected slots, once no emission is iterating them.
+            void compact()
+                {
+                std::erase_if(_slots, [](slot* s)
+                    {
+                    if (s->connected) return false;
+                    s->stale = nullptr;
+                    detail::release(s);
+                    return true;
+                    });
+                _stale = false;
+                }
+
+            template <typename... U>
+            void operator()(
+                U&&... args
+                )
+                {
+                if (_blocked) return;
+                struct emission {
+                    unsynchronized_signal& signal;
+
+                    ~emission()
+                        {
+                        if (--signal._emitting == 0 && signal._stale) signal.compact();
+                        }
+                } guard {*this};
+
+                ++_emitting;
+                auto count = _slots.size();
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto s = _slots[i];
+
+                    if (s->connected && !s->blocked) s->fn(args ...);
+                    }
+                }
+
+        public:
+            unsynchronized_signal() = default;
+
+            unsynchronized_signal(unsynchronized_signal const&)            = delete;
+            unsynchronized_signal& operator=(unsynchronized_signal const&) = delete;
+
+            /**
+             * @brief Takes over the slots of another signal, which must not be
+             * emitting. Their connections remain valid.
+             */
+            unsynchronized_signal(
+                unsynchronized_signal&& other
+                ) noexcept
+                : _slots(std::move(other._slots))
+                , _stale(std::exchange(other._stale, false))
+                , _blocked(other._blocked)
+                {
+                for (auto s : _slots) s->stale = &_stale;
+                }
+
+            unsynchronized_signal& operator=(
+                unsynchronized_signal&& other
+                ) noexcept
+                {
+                if (this == &other) return *this;
+                disconnect_all();
+                _slots   = std::move(other._slots);
+                _stale   = std::exchange(other._stale, false);
+                _blocked = other._blocked;
+
+                for (auto s : _slots) s->stale = &_stale;
+                return *this;
+                }
+
+            ~unsynchronized_signal()
+                {
+                disconnect_all();
+                }
+
+            /**
+             * @brief Connects a callable as a slot.
+             */
+            template <typename Fn>
+            requires std::is_invocable_v<Fn&, T...>
+            unsynchronized_connection connect(
+                Fn&& fn
+                )
+                {
+                if (_stale && !_emitting) compact();
+                auto s = new slot;
+
+                s->fn    = std::forward<Fn>(fn);
+                s->stale = &_stale;
+                _slots.push_back(s);
+                return unsynchronized_connection(s);
+                }
+
+            /**
+             * @brief Connects a member function of an object as a slot.
+             */
+            template <typename Pmf, typename Ptr>
+            requires std::is_member_function_pointer_v<Pmf>
+            unsynchronized_connection connect(
+                Pmf pmf,
+                Ptr ptr
+                )
+                {
+                return connect([pmf, ptr](T... args)
+                    {
+                    ((*ptr).*pmf)(args ...);
+                    });
+                }
+
+            /**
+             * @brief Disconnects every slot.
+             */
+            void disconnect_all()
+                {
+                for (auto s : _slots) s->connected = false;
+                _stale = true;
+                if (!_emitting) compact();
+                }
+
+            /**
+             * @brief Gets the number of connected slots.
+             */
+            std::size_t slot_count() const
+                {
+                std::size_t count = 0;
+
+                for (auto s : _slots) count += s->connected;
+                return count;
+                }
+
+            void block()
+                {
+                _blocked = true;
+                }
+
+            void unblock()
+                {
+                _blocked = false;
+                }
+
+            bool blocked() const
+                {
+                return _blocked;
+                }
+        };
+        }
+    }
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Incremental state patches between owners. A patch holds only the
+ * registered properties whose version changed since a baseline, and is
+ * applied to another owner through the properties' setters.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_PATCH_HPP
+#define MB_MEMPROP_PATCH_HPP
+#include <memprop/snapshot.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief The versions of an owner's registered properties at some point
+         * in time. Computed properties always have version zero.
+         */
+        template <typename Owner>
+        using property_versions = std::array<std::uint32_t, properties_of<Owner>::size()>;
+
+        namespace detail {
+            inline constexpr std::uint32_t patch_magic   = 0x5450504D; // "MPPT"
+            inline constexpr std::uint16_t patch_version = 1;
+            }
+
+
+        /**
+         * @brief Captures the current versions of an owner's registered
+         * properties, for use as the baseline of a later patch.
+         */
+        template <detail::HasPropertyRegistry Owner>
+        property_versions<Owner> capture_versions(
+            Owner const& owner
+            )
+            {
+            property_versions<Owner> versions {};
+            std::size_t              i = 0;
+
+            properties_of<Owner>::for_each(owner, [&](std::string_view, auto const& p)
+                {
+                using prop_type = std::remove_cvref_t<decltype(p)>;
+
+                if constexpr (detail::SettableProperty<prop_type>) versions[i] = p.version();
+                ++i;
+                });
+            return versions;
+            }
+
+        /**
+         * @brief Writes a patch holding the values of the registered properties
+         * of an owner whose versions differ from the given baseline. Values are
+         * not compared, so a property set back to its old value is included.
+         * Every set advances a property's version, including silent sets such
+         * as restore_snapshot() with restore_notify::none and animation frames.
+         * Only values changed without going through the property, such as the
+         * storage of a backed property written by its owner directly, leave
+         * versions unchanged and are missed.
+         *
+         * @param owner The owner to take values from.
+         * @param since The baseline versions, usually from capture_versions().
+         * @param out The buffer to append the patch to.
+         *
+         * @return The number of properties written to the patch.
+         */
+        template <detail::HasPropertyRegistry Owner>
+        std::size_t make_patch(
+            Owner const&                    owner,
+            property_versions<Owner> const& since,
+            std::vector<std::byte>&         out
+            )
+            {
+            using schema = detail::snapshot_schema<properties_of<Owner>>;
+
+            byte_writer   writer(out);
+            std::uint16_t count = 0;
+
+            writer.write(detail::patch_magic);
+            writer.write(detail::patch_version);
+            writer.write(schema::hash());
+            auto countOffset = out.size();
+            writer.write(count);
+            std::uint16_t i  = 0;
+
+            properties_of<Owner>::for_each(owner, [&](std::string_view, auto const& p)
+                {
+                using prop_type = std::remove_cvref_t<decltype(p)>;
+
+                if constexpr (detail::SettableProperty<prop_type>) {
+                    if (p.version() != since[i]) {
+                        writer.write(i);
+                        serializer<detail::snapshot_value<prop_type>>::write(
+                            detail::property_access::get(p), writer);
+                        ++count;
+                        }
+                    }
+                ++i;
+                });
+            std::memcpy(out.data() + countOffset, &count, sizeof(count));
+            return count;
+            }
+
+        /**
+         * @brief Applies a patch to an owner. Each value goes through the
+         * property's setter, so custom setters and validation run, and Changed
+         * is emitted as usual. Readonly properties are patched as well.
+         *
+         * @param owner The owner to apply the patch to.
+         * @param in The patch data.
+         */
+        template <detail::HasPropertyRegistry Owner>
+        snapshot_status apply_patch(
+            Owner&                     owner,
+            std::span<std::byte const> in
+            )
+            {
+            using props  = properties_of<Owner>;
+            using schema = detail::snapshot_schema<props>;
+
+            byte_reader   reader(in);
+            std::uint32_t magic;
+            std::uint16_t version, count;
+            std::uint64_t hash;
+
+            if (!reader.read(magic) || magic != detail::patch_magic) {
+                return snapshot_status::bad_magic;
+                }
+            if (!reader.read(version)) return snapshot_status::truncated;
+            if (version != detail::patch_version) return snapshot_status::version_mismatch;
+            if (!reader.read(hash) || !reader.read(count)) return snapshot_status::truncated;
+            if (hash != schema::hash()) return snapshot_status::schema_mismatch;
+
+            for (std::uint16_t n = 0; n < count; ++n) {
+                std::uint16_t index;
+                auto          status = snapshot_status::corrupt;
+
+                if (!reader.read(index)) return snapshot_status::truncated;
+                props::visit(owner, index, [&](auto& p)
+                    {
+                    using prop_type = std::remove_cvref_t<decltype(p)>;
+
+                    if constexpr (detail::SettableProperty<prop_type>) {
+                        detail::snapshot_value<prop_type> v {};
+
+                        if (serializer<detail::snapshot_value<prop_type>>::read(reader, v)) {
+                            detail::property_access::set(p, v);
+                            status = snapshot_status::ok;
+                            } else {
+                            status = snapshot_status::truncated;
+                            }
+                        }
+                    });
+
+                if (status != snapshot_status::ok) return status;
+                }
+            return snapshot_status::ok;
+            }
+        }
+    }
+#endif
@@ -0,0 +1,397 @@
+/*
+ * Compile-time registration of an owner's member properties. Properties
+ * are declared as a list of named member pointers, which supports
+ * enumeration, index-based access, and name lookup through a perfect
+ * hash generated at compile time.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_REGISTRY_HPP
+#define MB_MEMPROP_REGISTRY_HPP
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief A string literal usable as a template argument.
+         */
+        template <std::size_t N>
+        struct fixed_string {
+            char value[N] {};
+
+            constexpr fixed_string(
+                char const (&s)[N]
+                )
+                {
+                for (std::size_t i = 0; i < N; ++i) value[i] = s[i];
+                }
+
+            constexpr std::string_view view() const
+                {
+                return {value, N - 1};
+                }
+        };
+
+
+        namespace detail {
+            template <typename>
+            struct member_pointer_traits {};
+
+            template <typename Class, typename Member>
+            struct member_pointer_traits<Member Class::*> {
+                using class_type  = Class;
+                using member_type = Member;
+            };
+
+
+            constexpr std::uint64_t name_hash(
+                std::string_view s,
+                std::uint64_t    seed
+                )
+                {
+                std::uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+
+                for (auto c : s) {
+                    h ^= static_cast<unsigned char>(c);
+                    h *= 1099511628211ull;
+                    }
+                h ^= h >> 29;
+                h *= 0xBF58476D1CE4E5B9ull;
+                h ^= h >> 32;
+                return h;
+                }
+
+            /**
+             * @brief A hash-and-displace perfect hash over a fixed set of names.
+             * Names are first hashed into one of N buckets; each bucket stores a
+             * seed for a second hash that places its names into distinct slots.
+             */
+            template <std::size_t N>
+            struct perfect_hash {
+                static constexpr std::size_t bucket_count = N ? N : 1;
+                static constexpr std::size_t slot_count   = N ? N + N / 4 + 1 : 1;
+                static constexpr std::size_t npos         = static_cast<std::size_t>(-1);
+                static constexpr std::uint32_t max_seed   = 4096;
+
+                std::array<std::uint32_t, bucket_count> seeds {};
+                std::array<std::size_t, slot_count> slots {};
+                bool complete = true;
+
+                /**
+                 * @brief Checks that no name is given twice, which no seed
+                 * could tell apart.
+                 */
+                static constexpr bool distinct(
+                    std::array<std::string_view, N> const& names
+                    )
+                    {
+                    for (std::size_t i = 0; i < N; ++i) {
+                        for (std::size_t j = i + 1; j < N; ++j) {
+                            if (names[i] == names[j]) return false;
+                            }
+                        }
+                    return true;
+                    }
+
+                constexpr perfect_hash(
+                    std::array<std::string_view, N> const& names
+                    )
+                    {
+                    for (auto& s : slots) s = npos;
+                    if (!distinct(names)) {
+                        complete = false;
+                        return;
+                        }
+                    std::array<std::size_t, N> bucketOf {};
+                    std::array<std::size_t, bucket_count> sizes {};
+
+                    for (std::size_t i = 0; i < N; ++i) {
+                        bucketOf[i] = name_hash(names[i], 0) % bucket_count;
+                        ++sizes[bucketOf[i]];
+                        }
+
+                    // place the largest buckets first, while slots are free
+                    std::array<std::size_t, bucket_count> order {};
+
+                    for (std::size_t b = 0; b < bucket_count; ++b) order[b] = b;
+                    for (std::size_t i = 1; i < bucket_count; ++i) {
+                        for (auto j = i; j > 0 && sizes[order[j - 1]] < sizes[order[j]]; --j) {
+                            std::swap(order[j - 1], order[j]);
+                            }
+                        }
+
+                    for (auto b : order) {
+                        if (!sizes[b]) break;
+                        for (std::uint32_t seed = 1;; ++seed) {
+                            if (seed > max_seed) {
+                                complete = false;
+                                return;
+                                }
+                            std::array<std::size_t, N> placed {};
+                            std::size_t count = 0;
+                            bool        fits  = true;
+
+                            for (std::size_t i = 0; i < N && fits; ++i) {
+                                if (bucketOf[i] != b) continue;
+                                auto slot = name_hash(names[i], seed) % slot_count;
+                                fits = slots[slot] == npos;
+
+                                for (std::size_t k = 0; k < count && fits; ++k) {
+                                    fits = placed[k] != slot;
+                                    }
+                                placed[count++] = slot;
+                                }
+
+                            if (!fits) continue;
+                            seeds[b] = seed;
+                            count    = 0;
+
+                            for (std::size_t i = 0; i < N; ++i) {
+                                if (bucketOf[i] == b) slots[placed[count++]] = i;
+                                }
+                            break;
+                            }
+                        }
+                    }
+
+                constexpr std::size_t find(
+                    std::string_view                       name,
+                    std::array<std::string_view, N> const& names
+                    ) const
+                    {
+                    if constexpr (N == 0) {
+                        return npos;
+                        } else {
+                        auto seed = seeds[name_hash(name, 0) % bucket_count];
+                        auto i    = slots[name_hash(name, seed) % slot_count];
+                        return i != npos && names[i] == name ? i : npos;
+                        }
+                    }
+            };
+            }
+
+
+        /**
+         * @brief Declares a named member property for a property_list.
+         *
+         * @tparam Name The name of the property.
+         * @tparam Member A pointer to the property member.
+         */
+        template <fixed_string Name, auto Member>
+        requires std::is_member_object_pointer_v<decltype(Member)>
+        struct property_entry {
+            using property_type = typename detail::member_pointer_traits<
+                decltype(Member)>::member_type;
+
+            static constexpr std::string_view name   = Name.view();
+            static constexpr auto             member = Member;
+        };
+
+
+        /**
+         * @brief Declares the member properties of an owner type. An owner
+         * registers its properties by declaring a public member alias named
+         * properties, or by specializing property_registry.
+         *
+         * @tparam Owner The type that contains the properties.
+         * @tparam Entries A list of property_entry types.
+         */
+        template <typename Owner, typename ... Entries>
+        class property_list {
+            using hash_type = detail::perfect_hash<sizeof...(Entries)>;
+
+            static constexpr std::array<std::string_view, sizeof...(Entries)> _names {
+                Entries::name ...
+                };
+            static constexpr hash_type _hash {_names};
+
+            static_assert(hash_type::distinct(_names), "The names in a property_list must be unique.");
+            static_assert(!hash_type::distinct(_names) || _hash.complete,
+                          "No perfect hash was found for the names in a property_list.");
+
+            template <std::size_t I>
+            using entry = std::tuple_element_t<I, std::tuple<Entries...>>;
+
+        public:
+            using owner_type = Owner;
+
+            static constexpr std::size_t npos = hash_type::npos;
+
+            /**
+             * @brief Gets the number of registered properties.
+             */
+            static constexpr std::size_t size()
+                {
+                return sizeof...(Entries);
+                }
+
+            /**
+             * @brief Gets the name of the property at the given index.
+             */
+            static constexpr std::string_view name(
+                std::size_t index
+                )
+                {
+                return _names[index];
+                }
+
+            /**
+             * @brief Finds the index of the property with the given name.
+             *
+             * @return The index, or npos if no property has that name.
+             */
+            static constexpr std::size_t index_of(
+                std::string_view name
+                )
+                {
+                return _hash.find(name, _names);
+                }
+
+            /**
+             * @brief Gets the property at the given index.
+             */
+            template <std::size_t I>
+            static auto& get(
+                Owner& owner
+                )
+                {
+                return owner.*entry<I>::member;
+                }
+
+            template <std::size_t I>
+            static auto const& get(
+                Owner const& owner
+                )
+                {
+                return owner.*entry<I>::member;
+                }
+
+            /**
+             * @brief Invokes the given function for each registered property,
+             * in declaration order, with the property's name and a reference
+             * to the property.
+             */
+            template <typename O, typename Fn>
+            requires std::same_as<std::remove_const_t<O>, Owner>
+            static void for_each(
+                O&   owner,
+                Fn&& fn
+                )
+                {
+                [&]<std::size_t ... I>(std::index_sequence<I...>)
+                    {
+                    (fn(_names[I], owner.*entry<I>::member), ...);
+                    } (std::index_sequence_for<Entries...>{});
+                }
+
+            /**
+             * @brief Invokes the given function with a reference to the property
+             * at the given index.
+             *
+             * @return False if the index is out of range.
+             */
+            template <typename O, typename Fn>
+            requires std::same_as<std::remove_const_t<O>, Owner>
+            static bool visit(
+                O&          owner,
+                std::size_t index,
+                Fn&&        fn
+                )
+                {
+                return [&]<std::size_t ... I>(std::index_sequence<I...>)
+                    {
+                    return ((index == I ? (fn(owner.*entry<I>::member), true) : false) || ...);
+                    } (std::index_sequence_for<Entries...>{});
+                }
+
+            /**
+             * @brief Invokes the given function with a reference to the property
+             * with the given name.
+             *
+             * @return False if no property has that name.
+             */
+            template <typename O, typename Fn>
+            requires std::same_as<std::remove_const_t<O>, Owner>
+            static bool visit(
+                O&               owner,
+                std::string_view name,
+                Fn&&             fn
+                )
+                {
+                auto index = index_of(name);
+                return index != npos && visit(owner, index, std::forward<Fn>(fn));
+                }
+        };
+
+
+        /**
+         * @brief Gets the property_list of an owner type. Defaults to the
+         * owner's member alias named properties.
+         */
+        template <typename Owner>
+        struct property_registry {};
+
+        template <typename Owner>
+        requires requires { typename Owner::properties; }
+        struct property_registry<Owner> {
+            using type = typename Owner::properties;
+        };
+
+        template <typename Owner>
+        using properties_of = typename property_registry<std::remove_const_t<Owner>>::type;
+
+        namespace detail {
+            template <typename Owner>
+            concept HasPropertyRegistry = requires {
+                    typename properties_of<Owner>;
+                };
+            }
+
+
+        /**
+         * @brief Invokes the given function for each registered property of an
+         * owner, with the property's name and a reference to the property.
+         */
+        template <detail::HasPropertyRegistry Owner, typename Fn>
+        void for_each_property(
+            Owner& owner,
+            Fn&&   fn
+            )
+            {
+            properties_of<Owner>::for_each(owner, std::forward<Fn>(fn));
+            }
+
+        /**
+         * @brief Gets the registered property of an owner at the given index.
+         */
+        template <std::size_t I, detail::HasPropertyRegistry Owner>
+        auto& get_property(
+            Owner& owner
+            )
+            {
+            return properties_of<Owner>::template get<I>(owner);
+            }
+
+        /**
+         * @brief Invokes the given function with a reference to the registered
+         * property of an owner with the given name.
+         *
+         * @return False if no property has that name.
+         */
+        template <detail::HasPropertyRegistry Owner, typename Fn>
+        bool visit_property(
+            Owner&           owner,
+            std::string_view name,
+            Fn&&             fn
+            )
+            {
+            return properties_of<Owner>::visit(owner, name, std::forward<Fn>(fn));
+            }
+        }
+    }
+#endif
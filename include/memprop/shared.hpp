@@ -0,0 +1,592 @@
+/*
+ * Publishing of property values to other processes through POSIX shared
+ * memory. Values of a trivially copyable layout struct are guarded by a
+ * seqlock, and subscribers are woken through a futex doorbell that only
+ * costs a system call when one of them is asleep. Requires Linux.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_SHARED_HPP
+#define MB_MEMPROP_SHARED_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <memprop/mapped.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief The state of a shared_subscriber's connection to its segment.
+         */
+        enum class shared_status {
+            connected,       ///< The segment is mapped and its publisher is alive.
+            not_found,       ///< No segment has the given name, or it is not yet initialized.
+            schema_mismatch, ///< The segment was published for a different layout.
+            closed,          ///< The publisher of the segment has been destroyed.
+            stalled,         ///< A write to the segment did not finish, as when its publisher died part way through it.
+            unavailable      ///< The segment could not be opened or mapped.
+        };
+
+
+        namespace detail {
+            inline constexpr std::uint32_t shared_magic   = 0x4853504D; // "MPSH"
+            inline constexpr std::uint16_t shared_version = 1;
+
+            struct shared_header {
+                std::atomic<std::uint32_t> magic;
+                std::uint16_t version;
+                std::uint16_t reserved;
+                std::uint64_t schema;
+                std::uint64_t size;
+                std::atomic<std::uint32_t> live;
+                std::atomic<std::uint32_t> sequence;
+
+                // written by the publisher on every change, and waited on by
+                // subscribers; kept apart from the seqlock
+                alignas(64) std::atomic<std::uint32_t> doorbell;
+                std::atomic<std::uint32_t> sleepers;
+            };
+
+
+            static_assert(std::atomic<std::uint32_t>::is_always_lock_free
+                          && sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+            template <typename Layout>
+            inline constexpr std::size_t shared_data_offset =
+                (sizeof(shared_header) + alignof(Layout) - 1) / alignof(Layout) * alignof(Layout);
+
+            template <typename Layout>
+            inline constexpr std::size_t shared_size = shared_data_offset<Layout> + sizeof(Layout);
+
+            inline void futex_wait(
+                std::atomic<std::uint32_t>& word,
+                std::uint32_t               expected,
+                timespec const*             timeout
+                )
+                {
+                ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT,
+                          expected, timeout, nullptr, 0);
+                }
+
+            inline void futex_wake(
+                std::atomic<std::uint32_t>& word
+                )
+                {
+                ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE,
+                          INT_MAX, nullptr, nullptr, 0);
+                }
+
+            // a reader spins this many times on a write in progress, then
+            // yields as many times again before giving up
+            inline constexpr int shared_read_spins = 128;
+
+            inline void cpu_relax() noexcept
+                {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+                asm volatile ("yield");
+#endif
+                }
+
+            template <auto Field, typename Layout>
+            std::size_t field_offset(
+                Layout const& layout
+                )
+                {
+                return reinterpret_cast<std::byte const*>(&(layout.*Field))
+                       - reinterpret_cast<std::byte const*>(&layout);
+                }
+            }
+
+
+        /**
+         * @brief Creates a shared memory segment holding one Layout value,
+         * and writes the values of properties to it as they change. Each write
+         * is guarded by the segment's seqlock, and rings its doorbell unless a
+         * batch is open, in which case the doorbell is rung once when the
+         * batch closes. Destroying the publisher unlinks the segment.
+         *
+         * @tparam Layout A trivially copyable struct of the published values.
+         */
+        template <typename Layout>
+        requires std::is_trivially_copyable_v<Layout>
+        class shared_publisher {
+            std::string _name;
+            std::byte* _map = nullptr;
+            detail::shared_header* _header = nullptr;
+            Layout* _data = nullptr;
+            std::vector<std::function<void()>> _disconnects;
+            int _batchDepth = 0;
+            bool _pending   = false;
+
+            void ring()
+                {
+                _pending = false;
+                _header->doorbell.fetch_add(1, std::memory_order_seq_cst);
+                if (_header->sleepers.load(std::memory_order_seq_cst)) {
+                    detail::futex_wake(_header->doorbell);
+                    }
+                }
+
+        public:
+            /**
+             * @brief Closes a batch of writes, ringing the doorbell once for all
+             * of them.
+             */
+            class batch {
+                shared_publisher& _publisher;
+
+            public:
+                explicit batch(
+                    shared_publisher& publisher
+                    )
+                    : _publisher(publisher)
+                    {
+                    ++_publisher._batchDepth;
+                    }
+
+                batch(batch const&)            = delete;
+                batch& operator=(batch const&) = delete;
+
+                ~batch()
+                    {
+                    if (--_publisher._batchDepth == 0 && _publisher._pending && _publisher._header) {
+                        _publisher.ring();
+                        }
+                    }
+            };
+
+
+            /**
+             * @brief Creates the named segment, replacing any segment of the
+             * same name. Subscribers of a replaced segment see it as closed.
+             *
+             * @param name The name of the segment, starting with a slash.
+             * @param schema The schema version of the layout.
+             * @param initial The initial values.
+             */
+            shared_publisher(
+                std::string   name,
+                std::uint32_t schema,
+                Layout const& initial = Layout {}
+                )
+                : _name(std::move(name))
+                {
+                constexpr auto size = detail::shared_size<Layout>;
+
+                ::shm_unlink(_name.c_str());
+                int fd = ::shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+
+                if (fd < 0) return;
+                if (::ftruncate(fd, size) == 0) {
+                    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+                    if (p != MAP_FAILED) _map = static_cast<std::byte*>(p);
+                    }
+                ::close(fd);
+                if (!_map) {
+                    ::shm_unlink(_name.c_str());
+                    return;
+                    }
+
+                _header           = new (_map) detail::shared_header {};
+                _data             = new (_map + detail::shared_data_offset<Layout>) Layout(initial);
+                _header->version  = detail::shared_version;
+                _header->schema   = detail::layout_hash<Layout>(std::string_view(), schema);
+                _header->size     = sizeof(Layout);
+                _header->live.store(1, std::memory_order_relaxed);
+                _header->magic.store(detail::shared_magic, std::memory_order_release);
+                }
+
+            shared_publisher(shared_publisher const&)            = delete;
+            shared_publisher& operator=(shared_publisher const&) = delete;
+
+            ~shared_publisher()
+                {
+                for (auto& d : _disconnects) d();
+                if (!_header) return;
+                _header->live.store(0, std::memory_order_seq_cst);
+                ring();
+                ::munmap(_map, detail::shared_size<Layout>);
+                ::shm_unlink(_name.c_str());
+                }
+
+            /**
+             * @brief Checks whether the segment was created.
+             */
+            bool valid() const
+                {
+                return _header;
+                }
+
+            /**
+             * @brief Writes a value to a field of the segment.
+             */
+            template <auto Field>
+            requires std::same_as<detail::mapped_layout<Field>, Layout>
+            void write(
+                typename detail::member_pointer_traits<decltype(Field)>::member_type const& v
+                )
+                {
+                if (!_header) return;
+                auto seq = _header->sequence.load(std::memory_order_relaxed);
+
+                _header->sequence.store(seq + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                std::memcpy(reinterpret_cast<std::byte*>(_data) + detail::field_offset<Field>(*_data),
+                            &v, sizeof(v));
+                _header->sequence.store(seq + 2, std::memory_order_release);
+
+                _pending = true;
+                if (!_batchDepth) ring();
+                }
+
+            /**
+             * @brief Writes the current value of a property to a field of the
+             * segment, and again each time the property emits Changed.
+             */
+            template <auto Field, typename Prop>
+            requires std::same_as<detail::mapped_layout<Field>, Layout>
+                  && requires(Prop& p) { p.Changed; }
+            void publish(
+                Prop& prop
+                )
+                {
+                using value_type = typename detail::member_pointer_traits<decltype(Field)>::member_type;
+
+                write<Field>(static_cast<value_type>(detail::property_access::get(prop)));
+                auto c = prop.Changed.connect([this](auto const& v)
+                    {
+                    write<Field>(static_cast<value_type>(v));
+                    });
+                _disconnects.emplace_back([c]() mutable
+                    {
+                    c.disconnect();
+                    });
+                }
+        };
+
+
+        template <typename Owner, auto Field>
+        class shared_property;
+
+
+        /**
+         * @brief Maps a shared memory segment created by a shared_publisher,
+         * and updates the shared_property objects attached to it. Values are
+         * read into a local copy by poll() or wait(), so properties only
+         * change, and emit Changed, on the subscriber's thread. Changes made
+         * between two polls are coalesced into one.
+         *
+         * @tparam Layout The layout struct of the publisher.
+         */
+        template <typename Layout>
+        requires std::is_trivially_copyable_v<Layout>
+        class shared_subscriber {
+            template <typename, auto>
+            friend class shared_property;
+
+            struct attachment {
+                void* prop;
+                std::size_t offset;
+                std::size_t size;
+                void (* notify)(void*);
+                bool changed;
+            };
+
+
+            std::string _name;
+            std::uint32_t _schema;
+            std::byte* _map = nullptr;
+            detail::shared_header* _header = nullptr;
+            Layout const* _data = nullptr;
+            Layout _local {};
+            Layout _next {};
+            std::uint32_t _seen = 0;
+            shared_status _status = shared_status::unavailable;
+            std::vector<attachment> _attached;
+
+            void unmap()
+                {
+                if (_map) ::munmap(_map, detail::shared_size<Layout>);
+                _map    = nullptr;
+                _header = nullptr;
+                _data   = nullptr;
+                }
+
+            // copies the values once no write is in progress, giving up if a
+            // write stays in progress
+            bool read(
+                Layout& out
+                ) const
+                {
+                for (int attempt = 0; attempt < 2 * detail::shared_read_spins; ++attempt) {
+                    auto before = _header->sequence.load(std::memory_order_acquire);
+
+                    if (!(before & 1)) {
+                        std::memcpy(&out, _data, sizeof(Layout));
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (_header->sequence.load(std::memory_order_relaxed) == before) return true;
+                        }
+                    if (attempt < detail::shared_read_spins) {
+                        detail::cpu_relax();
+                        } else {
+                        std::this_thread::yield();
+                        }
+                    }
+                return false;
+                }
+
+        public:
+            /**
+             * @brief Opens the named segment.
+             *
+             * @param name The name of the segment, starting with a slash.
+             * @param schema The schema version of the layout.
+             */
+            shared_subscriber(
+                std::string   name,
+                std::uint32_t schema
+                )
+                : _name(std::move(name))
+                , _schema(schema)
+                {
+                open();
+                }
+
+            shared_subscriber(shared_subscriber const&)            = delete;
+            shared_subscriber& operator=(shared_subscriber const&) = delete;
+
+            ~shared_subscriber()
+                {
+                unmap();
+                }
+
+            /**
+             * @brief Opens the named segment again, for instance once its
+             * publisher has started or been replaced. Attached properties are
+             * updated by the next poll.
+             */
+            shared_status open()
+                {
+                constexpr auto size = detail::shared_size<Layout>;
+
+                unmap();
+                _status = shared_status::not_found;
+                int fd = ::shm_open(_name.c_str(), O_RDWR | O_CLOEXEC, 0);
+
+                if (fd < 0) return _status;
+                struct stat st;
+
+                if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(detail::shared_header)) {
+                    ::close(fd);
+                    return _status;
+                    }
+                auto mapped = std::min<std::size_t>(st.st_size, size);
+                void* p     = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+                ::close(fd);
+                if (p == MAP_FAILED) return _status = shared_status::unavailable;
+
+                auto header = static_cast<detail::shared_header*>(p);
+
+                if (header->magic.load(std::memory_order_acquire) != detail::shared_magic) {
+                    ::munmap(p, mapped);
+                    return _status;
+                    }
+                if (header->version != detail::shared_version || header->size != sizeof(Layout)
+                    || header->schema != detail::layout_hash<Layout>(std::string_view(), _schema) || mapped != size) {
+                    ::munmap(p, mapped);
+                    return _status = shared_status::schema_mismatch;
+                    }
+                _map    = static_cast<std::byte*>(p);
+                _header = header;
+                _data   = std::launder(reinterpret_cast<Layout const*>(_map + detail::shared_data_offset<Layout>));
+                _seen   = _header->doorbell.load(std::memory_order_acquire) - 1;
+                return _status = shared_status::connected;
+                }
+
+            /**
+             * @brief Gets the state of the connection to the segment.
+             */
+            shared_status status() const
+                {
+                if (_header && !_header->live.load(std::memory_order_acquire)) {
+                    return shared_status::closed;
+                    }
+                return _status;
+                }
+
+            /**
+             * @brief Gets the values read by the last poll.
+             */
+            Layout const& data() const
+                {
+                return _local;
+                }
+
+            /**
+             * @brief Reads the values if the publisher has written since the
+             * last poll, then emits Changed for each attached property whose
+             * value differs. If a write is still in progress after a short
+             * wait, nothing is read, the status becomes stalled, and the next
+             * poll tries again.
+             *
+             * @return True if any attached property changed.
+             */
+            bool poll()
+                {
+                if (!_header) return false;
+                auto bell = _header->doorbell.load(std::memory_order_acquire);
+
+                if (bell == _seen) return false;
+                if (!read(_next)) {
+                    _status = shared_status::stalled;
+                    return false;
+                    }
+                _seen   = bell;
+                _status = shared_status::connected;
+
+                auto local = reinterpret_cast<std::byte const*>(&_local);
+                auto next  = reinterpret_cast<std::byte const*>(&_next);
+                bool any   = false;
+
+                for (auto& a : _attached) {
+                    a.changed = std::memcmp(local + a.offset, next + a.offset, a.size) != 0;
+                    any      |= a.changed;
+                    }
+                _local = _next;
+
+                // notify once every value is in place, as slots may read others
+                for (std::size_t i = 0; i < _attached.size(); ++i) {
+                    auto a = _attached[i];
+
+                    if (a.changed) a.notify(a.prop);
+                    }
+                return any;
+                }
+
+            /**
+             * @brief Waits until the publisher writes, or the timeout
+             * elapses, and then polls.
+             *
+             * @return True if any attached property changed.
+             */
+            bool wait(
+                std::chrono::nanoseconds timeout
+                )
+                {
+                if (!_header) return false;
+                auto& header = *_header;
+
+                if (header.doorbell.load(std::memory_order_acquire) == _seen) {
+                    auto     secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+                    timespec ts {static_cast<time_t>(secs.count()),
+                                 static_cast<long>((timeout - secs).count())};
+
+                    header.sleepers.fetch_add(1, std::memory_order_seq_cst);
+                    if (header.doorbell.load(std::memory_order_seq_cst) == _seen) {
+                        detail::futex_wait(header.doorbell, _seen, &ts);
+                        }
+                    header.sleepers.fetch_sub(1, std::memory_order_seq_cst);
+                    }
+                return poll();
+                }
+        };
+
+
+        namespace detail {
+            template <typename Owner, auto Field>
+            struct property_traits<shared_property<Owner, Field>> {
+                using owner_type      = Owner;
+                using property_type   = shared_property<Owner, Field>;
+                using value_type      = typename member_pointer_traits<decltype(Field)>::member_type;
+                using const_reference = value_type const&;
+            };
+            }
+
+
+        /**
+         * @brief Exposes a read-only property whose value is a field of a
+         * segment published by another process. The value is updated, and
+         * Changed emitted, when the subscriber polls.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam Field A pointer to the field of the subscriber's layout that
+         * holds the value.
+         */
+        template <typename Owner, auto Field>
+        class shared_property
+            : public readonly_property_base<shared_property<Owner, Field>> {
+            using my_type = shared_property<Owner, Field>;
+            using subscriber_type = shared_subscriber<detail::mapped_layout<Field>>;
+
+            subscriber_type* _subscriber;
+
+            friend Owner;
+        public:
+            using value_type      = detail::traits::value_type<my_type>;
+            using const_reference = detail::traits::const_reference<my_type>;
+            shared_property(
+                Owner*           owner,
+                subscriber_type& subscriber
+                )
+                : readonly_property_base<my_type>(owner)
+                , _subscriber(&subscriber)
+                {
+                _subscriber->_attached.push_back({
+                    this, detail::field_offset<Field>(_subscriber->_local), sizeof(value_type),
+                    [](void* p)
+                        {
+                        detail::property_access::notify(
+                            *static_cast<detail::settable_prop<my_type>*>(static_cast<my_type*>(p)));
+                        },
+                    false
+                    });
+                }
+
+            shared_property(shared_property const&)            = delete;
+            shared_property& operator=(shared_property const&) = delete;
+
+            ~shared_property()
+                {
+                std::erase_if(_subscriber->_attached, [this](auto const& a)
+                    {
+                    return a.prop == this;
+                    });
+                }
+
+        protected:
+            const_reference get() const override
+                {
+                return _subscriber->_local.*Field;
+                }
+
+        private:
+            bool do_set(
+                const_reference
+                ) override
+                {
+                return false;
+                }
+        };
+        }
+    }
+#endif
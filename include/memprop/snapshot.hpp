@@ -0,0 +1,546 @@
+/*
+ * Compact binary snapshots of the registered properties of owners.
+ * Trivially copyable values are block copied, and other value types are
+ * written by per-type serializers.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_SNAPSHOT_HPP
+#define MB_MEMPROP_SNAPSHOT_HPP
+#include <cstddef>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+#include <memprop/registry.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief Appends raw bytes to a snapshot buffer.
+         */
+        class byte_writer {
+            std::vector<std::byte>& _out;
+
+        public:
+            explicit byte_writer(
+                std::vector<std::byte>& out
+                )
+                : _out(out)
+                {
+                }
+
+            void write(
+                void const* data,
+                std::size_t size
+                )
+                {
+                auto offset = _out.size();
+                _out.resize(offset + size);
+                std::memcpy(_out.data() + offset, data, size);
+                }
+
+            template <typename T>
+            requires std::is_trivially_copyable_v<T>
+            void write(
+                T const& v
+                )
+                {
+                write(&v, sizeof(T));
+                }
+        };
+
+
+        /**
+         * @brief Reads raw bytes from a snapshot buffer.
+         */
+        class byte_reader {
+            std::span<std::byte const> _in;
+            std::size_t _offset = 0;
+
+        public:
+            explicit byte_reader(
+                std::span<std::byte const> in
+                )
+                : _in(in)
+                {
+                }
+
+            /**
+             * @brief Copies the next size bytes into data.
+             *
+             * @return False if fewer than size bytes remain.
+             */
+            bool read(
+                void*       data,
+                std::size_t size
+                )
+                {
+                if (remaining() < size) return false;
+                std::memcpy(data, _in.data() + _offset, size);
+                _offset += size;
+                return true;
+                }
+
+            template <typename T>
+            requires std::is_trivially_copyable_v<T>
+            bool read(
+                T& v
+                )
+                {
+                return read(&v, sizeof(T));
+                }
+
+            /**
+             * @brief Gets a view of the next size bytes and advances past them.
+             *
+             * @return An empty span if fewer than size bytes remain.
+             */
+            std::span<std::byte const> take(
+                std::size_t size
+                )
+                {
+                if (remaining() < size) return {};
+                auto out = _in.subspan(_offset, size);
+                _offset += size;
+                return out;
+                }
+
+            std::size_t remaining() const
+                {
+                return _in.size() - _offset;
+                }
+
+            std::size_t offset() const
+                {
+                return _offset;
+                }
+        };
+
+
+        /**
+         * @brief Writes and reads values of a type in snapshots. Trivially
+         * copyable types are block copied; other types must specialize this
+         * template with static write(T const&, byte_writer&) and
+         * read(byte_reader&, T&) functions.
+         *
+         * A specialization may also declare a static constexpr string_view
+         * named tag that identifies the written format in the schema hash.
+         * It must not depend on the compiler or standard library. Without a
+         * tag, arithmetic types are identified by their kind and size, and
+         * other trivially copyable types by their size and alignment.
+         */
+        template <typename T>
+        struct serializer;
+
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        struct serializer<T> {
+            static void write(
+                T const&     v,
+                byte_writer& out
+                )
+                {
+                out.write(v);
+                }
+
+            static bool read(
+                byte_reader& in,
+                T&           v
+                )
+                {
+                return in.read(v);
+                }
+        };
+
+        template <typename Char, typename Traits, typename Alloc>
+        struct serializer<std::basic_string<Char, Traits, Alloc>> {
+            using string_type = std::basic_string<Char, Traits, Alloc>;
+
+            static constexpr std::string_view tag = sizeof(Char) == 1 ? "string8"
+                                                  : sizeof(Char) == 2 ? "string16"
+                                                                      : "string32";
+
+            static void write(
+                string_type const& v,
+                byte_writer&       out
+                )
+                {
+                out.write(static_cast<std::uint32_t>(v.size()));
+                out.write(v.data(), v.size() * sizeof(Char));
+                }
+
+            static bool read(
+                byte_reader& in,
+                string_type& v
+                )
+                {
+                std::uint32_t size;
+
+                if (!in.read(size)) return false;
+                auto bytes = in.take(size * sizeof(Char));
+
+                if (bytes.size() != size * sizeof(Char)) return false;
+                v.resize(size);
+                std::memcpy(v.data(), bytes.data(), bytes.size());
+                return true;
+                }
+        };
+
+
+        /**
+         * @brief Controls how Changed signals are emitted when restoring.
+         */
+        enum class restore_notify {
+            each,     ///< Each property emits Changed as soon as it is restored.
+            none,     ///< No Changed signals are emitted.
+            coalesced ///< Changed is emitted for every restored property once all values are restored.
+        };
+
+
+        /**
+         * @brief The result of restoring a snapshot.
+         */
+        enum class snapshot_status {
+            ok,
+            bad_magic,        ///< The data is not a memprop snapshot.
+            version_mismatch, ///< The snapshot was written with a different format version.
+            schema_mismatch,  ///< The snapshot was written for a different set of properties.
+            count_mismatch,   ///< The snapshot holds a different number of owners.
+            truncated,        ///< The data ended before all values were read.
+            corrupt           ///< The data refers to a property that cannot be restored.
+        };
+
+
+        namespace detail {
+            inline constexpr std::uint32_t snapshot_magic   = 0x4E53504D; // "MPSN"
+            inline constexpr std::uint16_t snapshot_version = 2;
+
+            constexpr std::uint64_t hash_combine(
+                std::uint64_t seed,
+                std::uint64_t v
+                )
+                {
+                return seed ^ (v + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+                }
+
+            template <typename P>
+            using snapshot_value = traits::value_type<std::remove_cvref_t<P>>;
+
+            template <typename Entry>
+            concept SnapshotEntry = SettableProperty<typename Entry::property_type>;
+
+            // Identifies how values of T are written, the same way for every
+            // compiler and standard library.
+            template <typename T>
+            constexpr std::uint64_t value_schema_hash()
+                {
+                if constexpr (requires { std::string_view(serializer<T>::tag); }) {
+                    return name_hash(serializer<T>::tag, 0);
+                    } else if constexpr (std::is_same_v<T, bool>) {
+                    return name_hash("bool", sizeof(T));
+                    } else if constexpr (std::is_floating_point_v<T>) {
+                    return name_hash("float", sizeof(T));
+                    } else if constexpr (std::is_integral_v<T>) {
+                    return name_hash(std::is_signed_v<T> ? "int" : "uint", sizeof(T));
+                    } else if constexpr (std::is_enum_v<T>) {
+                    return hash_combine(name_hash("enum", 0), value_schema_hash<std::underlying_type_t<T>>());
+                    } else {
+                    return name_hash("trivial", sizeof(T) << 8 | alignof(T));
+                    }
+                }
+
+            template <typename Entry>
+            constexpr std::uint64_t entry_schema_hash()
+                {
+                using value_type = snapshot_value<typename Entry::property_type>;
+                return hash_combine(name_hash(Entry::name, 0), value_schema_hash<value_type>());
+                }
+
+            template <typename List>
+            struct snapshot_schema;
+
+            template <typename Owner, typename ... Entries>
+            struct snapshot_schema<property_list<Owner, Entries...>> {
+                // the number of settable properties, whose values are stored
+                static constexpr std::size_t stored_count =
+                    (std::size_t{0} + ... + (SnapshotEntry<Entries> ? 1 : 0));
+
+                static constexpr std::uint64_t hash()
+                    {
+                    std::uint64_t h = snapshot_version;
+                    ((h = SnapshotEntry<Entries> ? hash_combine(h, entry_schema_hash<Entries>()) : h),
+                     ...);
+                    return h;
+                    }
+
+                // the size of one owner's record if every value is block copied
+                static constexpr std::size_t fixed_size()
+                    {
+                    if constexpr ((... && (!SnapshotEntry<Entries>
+                                           || std::is_trivially_copyable_v<
+                                               snapshot_value<typename Entries::property_type>>))) {
+                        return (std::size_t{0} + ... + (SnapshotEntry<Entries>
+                                                        ? sizeof(snapshot_value<
+                                                                     typename Entries::property_type>)
+                                                        : 0));
+                        } else {
+                        return 0;
+                        }
+                    }
+            };
+
+            template <typename Owner>
+            void write_owner(
+                Owner const& owner,
+                byte_writer& out
+                )
+                {
+                properties_of<Owner>::for_each(owner, [&](std::string_view, auto const& p)
+                    {
+                    using prop_type = std::remove_cvref_t<decltype(p)>;
+
+                    if constexpr (SettableProperty<prop_type>) {
+                        serializer<snapshot_value<prop_type>>::write(
+                            property_access::get(p), out);
+                        }
+                    });
+                }
+
+            template <typename Owner>
+            void write_owner_fixed(
+                Owner const& owner,
+                std::byte*   out
+                )
+                {
+                properties_of<Owner>::for_each(owner, [&](std::string_view, auto const& p)
+                    {
+                    using prop_type = std::remove_cvref_t<decltype(p)>;
+
+                    if constexpr (SettableProperty<prop_type>) {
+                        auto const& v = property_access::get(p);
+                        std::memcpy(out, &v, sizeof(v));
+                        out += sizeof(v);
+                        }
+                    });
+                }
+
+            // Reads one owner's values. Properties that were set are recorded in
+            // restored, one bit per stored property, starting at bit.
+            template <typename Owner>
+            bool read_owner(
+                Owner&                      owner,
+                byte_reader&                in,
+                restore_notify              mode,
+                std::vector<std::uint64_t>& restored,
+                std::size_t                 bit
+                )
+                {
+                auto ok = true;
+
+                properties_of<Owner>::for_each(owner, [&](std::string_view, auto& p)
+                    {
+                    using prop_type = std::remove_cvref_t<decltype(p)>;
+
+                    if constexpr (SettableProperty<prop_type>) {
+                        snapshot_value<prop_type> v {};
+
+                        if (!ok || !(ok = serializer<snapshot_value<prop_type>>::read(in, v))) return;
+                        if (mode == restore_notify::each) {
+                            property_access::replay(p, v);
+                            } else if (property_access::set_silent(p, v)
+                                       && mode == restore_notify::coalesced) {
+                            restored[bit / 64] |= std::uint64_t{1} << (bit % 64);
+                            }
+                        ++bit;
+                        }
+                    });
+                return ok;
+                }
+
+            template <typename Owner>
+            void notify_owner(
+                Owner&                            owner,
+                std::vector<std::uint64_t> const& restored,
+                std::size_t                       bit
+                )
+                {
+                properties_of<Owner>::for_each(owner, [&](std::string_view, auto& p)
+                    {
+                    using prop_type = std::remove_cvref_t<decltype(p)>;
+
+                    if constexpr (SettableProperty<prop_type>) {
+                        if (restored[bit / 64] >> (bit % 64) & 1) property_access::notify(p);
+                        ++bit;
+                        }
+                    });
+                }
+
+            template <typename R>
+            using range_owner = std::remove_cvref_t<
+                decltype(*std::ranges::begin(std::declval<R&>()))>;
+
+            template <typename R>
+            decltype(auto) deref_owner(
+                R&& r
+                )
+                {
+                if constexpr (std::is_pointer_v<std::remove_cvref_t<R>>
+                              || requires { r.get(); *r; }) {
+                    return *r;
+                    } else {
+                    return std::forward<R>(r);
+                    }
+                }
+            }
+
+
+        /**
+         * @brief Writes the values of the registered, settable properties of a
+         * range of owners to a buffer. The range may hold owners, or pointers
+         * to owners.
+         *
+         * The format is a header (magic, format version, schema hash and owner
+         * count) followed by each owner's values in registration order.
+         *
+         * @param owners The owners to save.
+         * @param out The buffer to append the snapshot to.
+         */
+        template <std::ranges::forward_range R>
+        void save_snapshot(
+            R&&                     owners,
+            std::vector<std::byte>& out
+            )
+            {
+            using owner_type = std::remove_cvref_t<decltype(
+                detail::deref_owner(*std::ranges::begin(owners)))>;
+            using schema     = detail::snapshot_schema<properties_of<owner_type>>;
+
+            byte_writer   writer(out);
+            std::uint64_t count = std::ranges::distance(owners);
+
+            writer.write(detail::snapshot_magic);
+            writer.write(detail::snapshot_version);
+            writer.write(schema::hash());
+            writer.write(count);
+
+            if constexpr (schema::fixed_size() != 0) {
+                // every value is block copied, so the whole buffer is sized once
+                auto offset = out.size();
+                out.resize(offset + count * schema::fixed_size());
+                auto dest   = out.data() + offset;
+
+                for (auto&& o : owners) {
+                    detail::write_owner_fixed(detail::deref_owner(o), dest);
+                    dest += schema::fixed_size();
+                    }
+                } else {
+                for (auto&& o : owners) {
+                    detail::write_owner(detail::deref_owner(o), writer);
+                    }
+                }
+            }
+
+        /**
+         * @brief Writes the values of the registered, settable properties of an
+         * owner to a buffer.
+         */
+        template <detail::HasPropertyRegistry Owner>
+        void save_snapshot(
+            Owner const&            owner,
+            std::vector<std::byte>& out
+            )
+            {
+            save_snapshot(std::span<Owner const>(&owner, 1), out);
+            }
+
+        /**
+         * @brief Restores the values of the registered, settable properties of
+         * a range of owners from a snapshot. Values go through each property's
+         * setter, including readonly properties. The range may hold owners, or
+         * pointers to owners, and must have as many elements as were saved.
+         *
+         * If every value is block copied, a truncated snapshot is detected
+         * before any property is set. Otherwise the owners read before the
+         * data ended keep their restored values.
+         *
+         * @param owners The owners to restore.
+         * @param in The snapshot data.
+         * @param mode How Changed signals are emitted.
+         */
+        template <std::ranges::forward_range R>
+        snapshot_status restore_snapshot(
+            R&&                        owners,
+            std::span<std::byte const> in,
+            restore_notify             mode = restore_notify::coalesced
+            )
+            {
+            using owner_type = std::remove_cvref_t<decltype(
+                detail::deref_owner(*std::ranges::begin(owners)))>;
+            using schema     = detail::snapshot_schema<properties_of<owner_type>>;
+
+            byte_reader   reader(in);
+            std::uint32_t magic;
+            std::uint16_t version;
+            std::uint64_t hash, count;
+
+            if (!reader.read(magic) || magic != detail::snapshot_magic) {
+                return snapshot_status::bad_magic;
+                }
+            if (!reader.read(version)) return snapshot_status::truncated;
+            if (version != detail::snapshot_version) return snapshot_status::version_mismatch;
+            if (!reader.read(hash) || !reader.read(count)) return snapshot_status::truncated;
+            if (hash != schema::hash()) return snapshot_status::schema_mismatch;
+            if (count != static_cast<std::uint64_t>(std::ranges::distance(owners))) {
+                return snapshot_status::count_mismatch;
+                }
+
+            std::vector<std::uint64_t> restored;
+
+            if (mode == restore_notify::coalesced) {
+                restored.assign((count * schema::stored_count + 63) / 64, 0);
+                }
+            // block copied records are checked up front, so a truncated
+            // snapshot leaves every owner unchanged
+            if constexpr (schema::fixed_size() != 0) {
+                if (reader.remaining() < count * schema::fixed_size()) return snapshot_status::truncated;
+                }
+            auto        status = snapshot_status::ok;
+            std::size_t bit    = 0;
+
+            for (auto&& o : owners) {
+                if (!detail::read_owner(detail::deref_owner(o), reader, mode, restored, bit)) {
+                    status = snapshot_status::truncated;
+                    break;
+                    }
+                bit += schema::stored_count;
+                }
+
+            if (mode == restore_notify::coalesced) {
+                bit = 0;
+
+                for (auto&& o : owners) {
+                    detail::notify_owner(detail::deref_owner(o), restored, bit);
+                    bit += schema::stored_count;
+                    }
+                }
+            return status;
+            }
+
+        /**
+         * @brief Restores the values of the registered, settable properties of
+         * an owner from a snapshot.
+         */
+        template <detail::HasPropertyRegistry Owner>
+        snapshot_status restore_snapshot(
+            Owner&                     owner,
+            std::span<std::byte const> in,
+            restore_notify             mode = restore_notify::coalesced
+            )
+            {
+            return restore_snapshot(std::span<Owner>(&owner, 1), in, mode);
+            }
+        }
+    }
+#endif
@@ -0,0 +1,496 @@
+/*
+ * Sparse member properties. A sparse property is a small handle in its
+ * owner. Unset properties resolve to a default value shared by every
+ * owner, and the value, signal and binding of a property are only
+ * allocated, in a side store kept by the owner, once it is set or
+ * observed.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_SPARSE_HPP
+#define MB_MEMPROP_SPARSE_HPP
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        namespace detail {
+            template <typename T>
+            using default_provider = T const& (*)();
+
+            struct sparse_cell_base {
+                virtual ~sparse_cell_base() = default;
+
+                virtual bool has_value() const = 0;
+            };
+
+
+            template <typename, typename, auto, typename, template <typename> class>
+            class sparse_cell;
+            template <typename Owner, typename V, auto Default, typename Policy>
+            class sparse_handle;
+            }
+
+
+        /**
+         * @brief Base class for owners of sparse properties. Holds the cells of
+         * the owner's sparse properties that have been set or observed, so an
+         * owner whose sparse properties are all unset stores a single empty
+         * vector. The cells are shared by all sparse properties of the owner,
+         * and are guarded by a mutex, so one property can be read while
+         * another is first set on a different thread.
+         */
+        class sparse_storage {
+            template <typename, typename, auto, typename>
+            friend class detail::sparse_handle;
+
+            struct entry {
+                std::uint32_t                              offset;
+                std::unique_ptr<detail::sparse_cell_base> cell;
+            };
+
+
+            mutable std::mutex _mutex;
+            std::vector<entry> _entries;
+
+            auto find_entry(
+                std::uint32_t offset
+                ) const
+                {
+                return std::lower_bound(_entries.begin(), _entries.end(), offset,
+                                        [](entry const& e, std::uint32_t o)
+                    {
+                    return e.offset < o;
+                    });
+                }
+
+            // cells are never removed, so they outlive the lock
+            detail::sparse_cell_base* find(
+                std::uint32_t offset
+                ) const
+                {
+                std::lock_guard lock(_mutex);
+                auto            it = find_entry(offset);
+
+                return it != _entries.end() && it->offset == offset ? it->cell.get() : nullptr;
+                }
+
+            template <typename Make>
+            detail::sparse_cell_base& find_or_insert(
+                std::uint32_t offset,
+                Make          make
+                )
+                {
+                std::lock_guard lock(_mutex);
+                auto            it = find_entry(offset);
+
+                if (it != _entries.end() && it->offset == offset) return *it->cell;
+                return *_entries.insert(it, entry {offset, make()})->cell;
+                }
+
+        protected:
+            sparse_storage() = default;
+
+        public:
+            sparse_storage(sparse_storage const&)            = delete;
+            sparse_storage& operator=(sparse_storage const&) = delete;
+
+            /**
+             * @brief Gets the number of sparse property values that are
+             * explicitly set on this owner.
+             */
+            std::size_t stored_count() const
+                {
+                std::lock_guard lock(_mutex);
+
+                return std::count_if(_entries.begin(), _entries.end(), [](entry const& e)
+                    {
+                    return e.cell->has_value();
+                    });
+                }
+        };
+
+
+        namespace detail {
+            template <typename Owner, typename V, auto Default, typename Policy,
+                      template <typename> class Base>
+            struct property_traits<sparse_cell<Owner, V, Default, Policy, Base>> {
+                using owner_type      = Owner;
+                using property_type   = sparse_cell<Owner, V, Default, Policy, Base>;
+                using value_type      = std::remove_cvref_t<V>;
+                using const_reference = value_type const&;
+                using policy_type     = Policy;
+            };
+
+
+            /**
+             * @brief The property behind a sparse property handle, created on
+             * the owner once the property is set or observed. It holds the
+             * explicitly set value, if any, and carries the signal and binding.
+             */
+            template <typename Owner, typename V, auto Default, typename Policy,
+                      template <typename> class Base>
+            class sparse_cell
+                : public sparse_cell_base,
+                  public Base<sparse_cell<Owner, V, Default, Policy, Base>> {
+                using my_type = sparse_cell<Owner, V, Default, Policy, Base>;
+
+                friend class sparse_handle<Owner, V, Default, Policy>;
+                friend Owner;
+            public:
+                using value_type      = detail::traits::value_type<my_type>;
+                using const_reference = detail::traits::const_reference<my_type>;
+
+                sparse_cell(
+                    Owner*      owner,
+                    property_id id
+                    )
+                    : Base<my_type>(owner, id)
+                    {
+                    }
+
+                static const_reference default_value()
+                    {
+                    if constexpr (Default == nullptr) {
+                        static value_type const value {};
+                        return value;
+                        } else {
+                        return Default();
+                        }
+                    }
+
+                bool has_value() const override
+                    {
+                    return _value.has_value();
+                    }
+
+            protected:
+                const_reference get() const override
+                    {
+                    return _value ? *_value : default_value();
+                    }
+
+            private:
+                bool do_set(
+                    const_reference v
+                    ) override
+                    {
+                    _value = v;
+                    return true;
+                    }
+
+                void clear()
+                    {
+                    if (!_value) return;
+                    _value.reset();
+                    this->invoke_changed(get());
+                    }
+
+                std::optional<value_type> _value;
+            };
+
+
+            /**
+             * @brief The part shared by sparse public and readonly properties.
+             * Only the offset of the handle within its owner and its property
+             * id are stored, from which the owner and its cell are found.
+             */
+            template <typename Owner, typename V, auto Default, typename Policy>
+            class sparse_handle {
+                std::uint32_t _offset;
+                property_id   _id = 0;
+
+            protected:
+                template <template <typename> class Base>
+                using cell_type = sparse_cell<Owner, V, Default, Policy, Base>;
+
+                sparse_handle(
+                    Owner* owner
+                    )
+                    : _offset(static_cast<std::uint32_t>(reinterpret_cast<char const*>(this)
+                                                         - reinterpret_cast<char const*>(owner)))
+                    {
+                    if constexpr (HasPropertyIds<Owner>) {
+                        _id = draw_property_id(static_cast<property_id_source&>(*owner));
+                        }
+                    }
+
+                Owner* owner() const
+                    {
+                    return reinterpret_cast<Owner*>(
+                        const_cast<char*>(reinterpret_cast<char const*>(this)) - _offset);
+                    }
+
+                sparse_storage& storage() const
+                    {
+                    static_assert(std::is_base_of_v<sparse_storage, Owner>,
+                                  "The owner of a sparse property must derive from sparse_storage.");
+                    return static_cast<sparse_storage&>(*owner());
+                    }
+
+                template <template <typename> class Base>
+                cell_type<Base>* find() const
+                    {
+                    return static_cast<cell_type<Base>*>(storage().find(_offset));
+                    }
+
+                template <template <typename> class Base>
+                cell_type<Base>& cell() const
+                    {
+                    auto& c = storage().find_or_insert(_offset, [this]
+                        {
+                        return std::make_unique<cell_type<Base>>(owner(), _id);
+                        });
+
+                    return static_cast<cell_type<Base>&>(c);
+                    }
+
+                template <template <typename> class Base>
+                std::remove_cvref_t<V> const& value() const
+                    {
+                    auto c = find<Base>();
+                    return c ? c->get() : cell_type<Base>::default_value();
+                    }
+
+                template <template <typename> class Base>
+                void set_value(
+                    std::remove_cvref_t<V> const& v
+                    )
+                    {
+                    cell<Base>().set(v);
+                    }
+
+                template <template <typename> class Base>
+                void clear_value()
+                    {
+                    if (auto c = find<Base>()) c->clear();
+                    }
+
+            public:
+                sparse_handle(sparse_handle const&)            = delete;
+                sparse_handle& operator=(sparse_handle const&) = delete;
+
+                /**
+                 * @brief Gets the id of this property within its owner. Always
+                 * zero if the owner does not assign property ids.
+                 */
+                property_id id() const
+                    {
+                    return _id;
+                    }
+
+                /**
+                 * @brief Gets the default value shared by all instances of the
+                 * property.
+                 */
+                static std::remove_cvref_t<V> const& default_value()
+                    {
+                    return cell_type<public_property_base>::default_value();
+                    }
+            };
+            }
+
+
+        /**
+         * @brief Exposes a property with a public getter and setter that takes
+         * no storage on its owner beyond a small handle until it is set or
+         * observed. Until it is set, and after a call to clear(), the property
+         * has its default value. Its Changed signal and binding belong to the
+         * property object returned by property(). Owner must derive from
+         * sparse_storage.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam V The value type.
+         * @tparam Default A pointer to a function that returns a reference to the
+         * default value. If null, the default is a value-initialized V.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
+         */
+        template <typename Owner, typename V,
+                  detail::default_provider<std::remove_cvref_t<V>> Default = nullptr,
+                  detail::ThreadingPolicy Policy = thread_safe>
+        class sparse_public_property
+            : public detail::sparse_handle<Owner, V, Default, Policy> {
+            using my_type   = sparse_public_property<Owner, V, Default, Policy>;
+            using handle    = detail::sparse_handle<Owner, V, Default, Policy>;
+            using cell_type = typename handle::template cell_type<public_property_base>;
+
+            friend Owner;
+        public:
+            using value_type      = std::remove_cvref_t<V>;
+            using const_reference = value_type const&;
+            using property_type   = cell_type;
+
+            sparse_public_property(
+                Owner* owner
+                )
+                : handle(owner)
+                {
+                }
+
+            my_type& operator=(
+                const_reference rhs
+                )
+                {
+                this->template set_value<public_property_base>(rhs);
+                return *this;
+                }
+
+            operator const_reference() const
+                {
+                return this->template value<public_property_base>();
+                }
+
+            /**
+             * @brief Gets the property object that carries the Changed signal
+             * and binding of this property, creating it if needed.
+             */
+            property_type& property()
+                {
+                return this->template cell<public_property_base>();
+                }
+
+            /**
+             * @brief Checks whether the property has an explicitly set value.
+             */
+            bool is_set() const
+                {
+                auto c = this->template find<public_property_base>();
+                return c && c->has_value();
+                }
+
+            /**
+             * @brief Removes the explicitly set value, if any, so that the
+             * property reverts to its default value.
+             */
+            void clear()
+                {
+                this->template clear_value<public_property_base>();
+                }
+
+            /**
+             * @brief Removes the binding from this property, if one exists.
+             */
+            void unbind()
+                {
+                if (auto c = this->template find<public_property_base>()) c->unbind();
+                }
+
+            /**
+             * @brief Binds this property to the value of another property.
+             *
+             * @param src The source property.
+             *
+             * @return A handle to the binding.
+             */
+            template <typename PSrc>
+            requires detail::PropertyConvertible<PSrc, property_type>
+            std::shared_ptr<binding> bind(
+                detail::settable_prop<PSrc>& src
+                )
+                {
+                return property().bind(src);
+                }
+
+            /**
+             * @brief Binds this property to the value of another property
+             * using the given converter object.
+             *
+             * @param src The source property.
+             * @param converter The converter object.
+             *
+             * @return A handle to the binding.
+             */
+            template <typename PSrc, typename Converter>
+            requires detail::ValidConverter<PSrc, property_type, Converter>
+            std::shared_ptr<binding> bind(
+                detail::settable_prop<PSrc>& src,
+                Converter&&                  converter
+                )
+                {
+                return property().bind(src, std::forward<Converter>(converter));
+                }
+        };
+
+
+        /**
+         * @brief Exposes a property with a public getter and a setter accessible only
+         * by Owner, that takes no storage on its owner beyond a small handle until
+         * it is set or observed. Owner must derive from sparse_storage.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam V The value type.
+         * @tparam Default A pointer to a function that returns a reference to the
+         * default value. If null, the default is a value-initialized V.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
+         */
+        template <typename Owner, typename V,
+                  detail::default_provider<std::remove_cvref_t<V>> Default = nullptr,
+                  detail::ThreadingPolicy Policy = thread_safe>
+        class sparse_readonly_property
+            : public detail::sparse_handle<Owner, V, Default, Policy> {
+            using my_type   = sparse_readonly_property<Owner, V, Default, Policy>;
+            using handle    = detail::sparse_handle<Owner, V, Default, Policy>;
+            using cell_type = typename handle::template cell_type<readonly_property_base>;
+
+            friend Owner;
+        public:
+            using value_type      = std::remove_cvref_t<V>;
+            using const_reference = value_type const&;
+            using property_type   = cell_type;
+
+            sparse_readonly_property(
+                Owner* owner
+                )
+                : handle(owner)
+                {
+                }
+
+            operator const_reference() const
+                {
+                return this->template value<readonly_property_base>();
+                }
+
+            /**
+             * @brief Gets the property object that carries the Changed signal
+             * and binding of this property, creating it if needed.
+             */
+            property_type& property()
+                {
+                return this->template cell<readonly_property_base>();
+                }
+
+            /**
+             * @brief Checks whether the property has an explicitly set value.
+             */
+            bool is_set() const
+                {
+                auto c = this->template find<readonly_property_base>();
+                return c && c->has_value();
+                }
+
+        protected:
+            my_type& operator=(
+                const_reference rhs
+                )
+                {
+                this->template set_value<readonly_property_base>(rhs);
+                return *this;
+                }
+
+            /**
+             * @brief Removes the explicitly set value, if any, so that the
+             * property reverts to its default value.
+             */
+            void clear()
+                {
+                this->template clear_value<readonly_property_base>();
+                }
+        };
+        }
+    }
+#endif
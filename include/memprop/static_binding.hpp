@@ -0,0 +1,218 @@
+/*
+ * Static bindings between the properties of one owner. The bindings are
+ * declared on the owner type, and a change is propagated by direct calls
+ * made from the setter, without binding objects or slot connections.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_STATIC_BINDING_HPP
+#define MB_MEMPROP_STATIC_BINDING_HPP
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <memprop/registry.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief Declares that a property of an owner follows one or more of
+         * the owner's other properties.
+         *
+         * @tparam Target A pointer to the member property that is set.
+         * @tparam Fn Computes the target's value from the sources' values.
+         * Either a callable, such as a captureless lambda, a pointer to a
+         * member function of the owner, or nullptr to copy a single source.
+         * @tparam Sources Pointers to the member properties the target follows.
+         */
+        template <auto Target, auto Fn, auto... Sources>
+        requires std::is_member_object_pointer_v<decltype(Target)>
+              && (sizeof...(Sources) > 0)
+              && (std::is_member_object_pointer_v<decltype(Sources)> && ...)
+        struct static_binding {
+            static constexpr auto target = Target;
+        };
+
+
+        /**
+         * @brief Lists the static bindings of an owner. An owner declares its
+         * static bindings with a public member alias named static_bindings.
+         * The bindings must not form a cycle.
+         */
+        template <typename... Bindings>
+        struct static_binding_list {};
+
+
+        namespace detail {
+            template <auto A, auto B>
+            constexpr bool same_member()
+                {
+                if constexpr (std::is_same_v<decltype(A), decltype(B)>) {
+                    return A == B;
+                    } else {
+                    return false;
+                    }
+                }
+
+            template <auto M>
+            using member_property = typename member_pointer_traits<decltype(M)>::member_type;
+
+            template <typename Binding>
+            struct static_binding_traits;
+
+            template <auto Target, auto Fn, auto... Sources>
+            struct static_binding_traits<static_binding<Target, Fn, Sources...>> {
+                template <auto Member>
+                static constexpr bool reads = (same_member<Member, Sources>() || ...);
+
+                template <typename Prop>
+                static constexpr bool reads_type =
+                    (std::is_same_v<member_property<Sources>, Prop> || ...);
+
+                template <auto Source, typename Owner, typename Prop>
+                static bool is_source(
+                    Owner&                     owner,
+                    settable_prop<Prop> const& p
+                    )
+                    {
+                    if constexpr (std::is_same_v<member_property<Source>, Prop>) {
+                        return static_cast<settable_prop<Prop> const*>(&(owner.*Source)) == &p;
+                        } else {
+                        return false;
+                        }
+                    }
+
+                template <typename Owner, typename Prop>
+                static bool reads_property(
+                    Owner&                     owner,
+                    settable_prop<Prop> const& p
+                    )
+                    {
+                    return (is_source<Sources>(owner, p) || ...);
+                    }
+
+                template <typename Owner>
+                static void apply(
+                    Owner& owner
+                    )
+                    {
+                    using fn_type = decltype(Fn);
+
+                    if constexpr (std::is_same_v<fn_type, std::nullptr_t>) {
+                        static_assert(sizeof...(Sources) == 1,
+                                      "A static binding without a function must have one source.");
+                        property_access::set(owner.*Target, property_access::get(owner.*Sources)...);
+                        } else if constexpr (std::is_member_function_pointer_v<fn_type>) {
+                        property_access::set(owner.*Target,
+                                             (owner.*Fn)(property_access::get(owner.*Sources)...));
+                        } else {
+                        property_access::set(owner.*Target,
+                                             std::invoke(Fn, property_access::get(owner.*Sources)...));
+                        }
+                    }
+            };
+
+
+            template <typename List>
+            struct static_graph;
+
+            template <typename... Bindings>
+            struct static_graph<static_binding_list<Bindings...>> {
+                static constexpr std::size_t size = sizeof...(Bindings);
+
+                // whether the target of From is a source of each binding
+                template <typename From>
+                static constexpr std::array<bool, size> reads_target()
+                    {
+                    return {static_binding_traits<Bindings>::template reads<From::target>...};
+                    }
+
+                // A binding whose target it reaches through other bindings
+                // would propagate forever.
+                static constexpr bool acyclic()
+                    {
+                    std::array<std::array<bool, size>, size> reach {};
+                    std::size_t                               i = 0;
+
+                    ((reach[i++] = reads_target<Bindings>()), ...);
+                    for (std::size_t k = 0; k < size; ++k) {
+                        for (std::size_t a = 0; a < size; ++a) {
+                            for (std::size_t b = 0; b < size; ++b) {
+                                reach[a][b] = reach[a][b] || (reach[a][k] && reach[k][b]);
+                                }
+                            }
+                        }
+                    for (std::size_t a = 0; a < size; ++a) {
+                        if (reach[a][a]) return false;
+                        }
+                    return true;
+                    }
+
+                template <typename Owner, typename Prop>
+                static void changed(
+                    Owner&                     owner,
+                    settable_prop<Prop> const& p
+                    )
+                    {
+                    static_assert(acyclic(), "The static bindings of an owner must not form a cycle.");
+                    (propagate<Bindings>(owner, p), ...);
+                    }
+
+                template <typename Owner>
+                static void apply_all(
+                    Owner& owner
+                    )
+                    {
+                    (static_binding_traits<Bindings>::apply(owner), ...);
+                    }
+
+            private:
+                template <typename Binding, typename Owner, typename Prop>
+                static void propagate(
+                    Owner&                     owner,
+                    settable_prop<Prop> const& p
+                    )
+                    {
+                    using binding_traits = static_binding_traits<Binding>;
+
+                    // a binding never reads its own target, and skipping it
+                    // outright keeps the setter from inlining into itself
+                    if constexpr (binding_traits::template reads_type<Prop>) {
+                        if (binding_traits::template is_source<Binding::target>(owner, p)) return;
+                        if (binding_traits::reads_property(owner, p)) binding_traits::apply(owner);
+                        }
+                    }
+            };
+
+
+            template <typename Owner>
+            struct static_propagation {
+                template <typename Prop>
+                static void changed(
+                    Owner&                     owner,
+                    settable_prop<Prop> const& p
+                    )
+                    {
+                    static_graph<typename Owner::static_bindings>::changed(owner, p);
+                    }
+            };
+            }
+
+
+        /**
+         * @brief Sets the target of each of an owner's static bindings from
+         * its sources, in the order they are listed. Owners call this once
+         * their properties are constructed, since static bindings only
+         * propagate changes.
+         */
+        template <typename Owner>
+        requires detail::HasStaticBindings<Owner>
+        void sync_static_bindings(
+            Owner& owner
+            )
+            {
+            detail::static_graph<typename Owner::static_bindings>::apply_all(owner);
+            }
+        }
+    }
+#endif
@@ -0,0 +1,298 @@
+/*
+ * Struct-of-arrays storage for member properties. A property_table
+ * keeps one property's values for all owners contiguously, and each
+ * owner holds a table_property handle into it.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_TABLE_HPP
+#define MB_MEMPROP_TABLE_HPP
+#include <algorithm>
+#include <span>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        template <typename Owner, typename V>
+        class property_table;
+        template <typename Owner, typename V>
+        class table_property;
+
+        namespace detail {
+            template <typename Owner, typename V>
+            struct property_traits<table_property<Owner, V>> {
+                using owner_type      = Owner;
+                using property_type   = table_property<Owner, V>;
+                using value_type      = std::remove_cvref_t<V>;
+                using const_reference = value_type const&;
+
+                // values live in the table's vector, which a slot can grow
+                // by creating another handle
+                static constexpr bool stable_values = false;
+            };
+            }
+
+
+        /**
+         * @brief Stores the values of one property for every owner of a type
+         * contiguously. Values are indexed in the order their handles were
+         * attached; when a handle is destroyed, the last value is moved into
+         * its slot. The table must outlive all of its handles. Handles may be
+         * created and destroyed by Changed slots, which are passed a copy of
+         * the value rather than a reference into the table.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam V The value type.
+         */
+        template <typename Owner, typename V>
+        class property_table {
+        public:
+            using value_type  = std::remove_cvref_t<V>;
+            using handle_type = table_property<Owner, V>;
+
+        private:
+            friend handle_type;
+
+            // wrapping the handle pointer keeps the handle's operators out of
+            // argument-dependent lookup on the vector's iterators
+            struct handle_ref {
+                handle_type* ptr;
+            };
+
+
+            std::vector<value_type> _values;
+            std::vector<handle_ref> _handles;
+
+            std::size_t attach(
+                handle_type*      handle,
+                value_type const& v
+                )
+                {
+                _values.push_back(v);
+                _handles.push_back({handle});
+                return _values.size() - 1;
+                }
+
+            void detach(
+                std::size_t index
+                )
+                {
+                auto last = _values.size() - 1;
+
+                if (index != last) {
+                    _values[index]              = std::move(_values[last]);
+                    _handles[index]             = _handles[last];
+                    _handles[index].ptr->_index = index;
+                    }
+                _values.pop_back();
+                _handles.pop_back();
+                }
+
+        public:
+            property_table() = default;
+            property_table(property_table const&)            = delete;
+            property_table(property_table&&)                 = delete;
+            property_table& operator=(property_table const&) = delete;
+            property_table& operator=(property_table&&)      = delete;
+
+            /**
+             * @brief Gets the number of values in the table.
+             */
+            std::size_t size() const
+                {
+                return _values.size();
+                }
+
+            /**
+             * @brief Gets the values of the table.
+             */
+            std::span<value_type const> values() const
+                {
+                return _values;
+                }
+
+            /**
+             * @brief Gets mutable access to the values of the table. Writing
+             * through the returned span does not emit any Changed signals; call
+             * notify_all() or notify() afterwards.
+             */
+            std::span<value_type> values()
+                {
+                return _values;
+                }
+
+            /**
+             * @brief Gets the property handle at the given index.
+             */
+            handle_type& handle(
+                std::size_t index
+                )
+                {
+                return *_handles[index].ptr;
+                }
+
+            /**
+             * @brief Copies every value of the table into the given span.
+             *
+             * @param out The destination. Must hold at least size() elements.
+             */
+            void get_all(
+                std::span<value_type> out
+                ) const
+                {
+                std::copy(_values.begin(), _values.end(), out.begin());
+                }
+
+            /**
+             * @brief Copies values into the table, then emits Changed on each
+             * affected property.
+             *
+             * @param in The new values, starting at index 0. Must not hold more
+             * than size() elements.
+             */
+            void set_all(
+                std::span<value_type const> in
+                )
+                {
+                std::copy(in.begin(), in.end(), _values.begin());
+                notify_range(0, in.size());
+                }
+
+            /**
+             * @brief Passes a span over all values of the table to the given
+             * function, then emits Changed on every property.
+             *
+             * @param fn A functor accepting a std::span<value_type>.
+             */
+            template <typename Fn>
+            requires std::invocable<Fn&, std::span<value_type>>
+            void update(
+                Fn&& fn
+                )
+                {
+                fn(std::span<value_type>(_values));
+                notify_all();
+                }
+
+            /**
+             * @brief Emits Changed on every property in the table.
+             */
+            void notify_all()
+                {
+                notify_range(0, _values.size());
+                }
+
+            /**
+             * @brief Emits Changed on the properties at the given indices.
+             */
+            void notify(
+                std::span<std::size_t const> indices
+                )
+                {
+                for (auto i : indices) {
+                    _handles[i].ptr->notify();
+                    }
+                }
+
+        private:
+            void notify_range(
+                std::size_t first,
+                std::size_t last
+                )
+                {
+                // Slots may add or remove handles, so the bound is re-read.
+                // Removing a handle moves the last one into its slot, and a
+                // handle moved to an index already notified is skipped.
+                for (auto i = first; i < last && i < _handles.size(); ++i) {
+                    _handles[i].ptr->notify();
+                    }
+                }
+        };
+
+
+        /**
+         * @brief Exposes a property with a public getter and setter whose value
+         * is stored in a property_table rather than in the property object.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam V The value type.
+         */
+        template <typename Owner, typename V>
+        class table_property
+            : public public_property_base<table_property<Owner, V>> {
+            using my_type         = table_property<Owner, V>;
+
+            friend Owner;
+            friend class property_table<Owner, V>;
+        public:
+            using value_type      = detail::traits::value_type<my_type>;
+            using const_reference = detail::traits::const_reference<my_type>;
+            using table_type      = property_table<Owner, V>;
+
+            table_property(
+                Owner*      owner,
+                table_type& table
+                )
+                : table_property(owner, table, value_type{})
+                {
+                }
+
+            table_property(
+                Owner*          owner,
+                table_type&     table,
+                const_reference v
+                )
+                : public_property_base<my_type>(owner)
+                , _table(&table)
+                , _index(table.attach(this, v))
+                {
+                }
+
+            ~table_property()
+                {
+                _table->detach(_index);
+                }
+
+            my_type& operator=(
+                const_reference rhs
+                )
+                {
+                this->set(rhs);
+                return *this;
+                }
+
+            /**
+             * @brief Gets the index of this property's value in its table.
+             */
+            std::size_t index() const
+                {
+                return _index;
+                }
+
+        protected:
+            const_reference get() const override
+                {
+                return _table->_values[_index];
+                }
+
+        private:
+            bool do_set(
+                const_reference v
+                ) override
+                {
+                _table->_values[_index] = v;
+                return true;
+                }
+
+            void notify()
+                {
+                this->invoke_changed(get());
+                }
+
+            table_type* _table;
+            std::size_t _index;
+        };
+        }
+    }
+#endif
@@ -0,0 +1,248 @@
+/*
+ * Timestamped sample history of numeric property values. A single writer
+ * records into a fixed-capacity ring, and any number of readers take
+ * lock-free snapshots of the recent window.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_TIMESERIES_HPP
+#define MB_MEMPROP_TIMESERIES_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief A value recorded at a point in time.
+         */
+        template <typename T>
+        struct sample {
+            std::chrono::steady_clock::time_point time;
+            T value;
+        };
+
+
+        /**
+         * @brief Summarizes the samples that fall within one span of time.
+         */
+        template <typename T>
+        struct sample_bucket {
+            std::chrono::steady_clock::time_point start;
+            T min;
+            T max;
+            double mean;
+            std::size_t count;
+        };
+
+
+        /**
+         * @brief Reduces samples to at most the given number of buckets of
+         * equal length in time, spanning from the first sample to the last.
+         * Buckets that hold no samples are omitted.
+         *
+         * @param samples The samples to reduce, in ascending order of time.
+         * @param buckets The maximum number of buckets.
+         * @param out The list that receives the buckets.
+         */
+        template <typename T>
+        void downsample(
+            std::span<sample<T> const>     samples,
+            std::size_t                    buckets,
+            std::vector<sample_bucket<T>>& out
+            )
+            {
+            out.clear();
+            if (samples.empty() || !buckets) return;
+
+            auto first = samples.front().time;
+            auto span  = samples.back().time - first;
+            auto width = span / static_cast<std::int64_t>(buckets) + std::chrono::nanoseconds(1);
+            std::size_t current = static_cast<std::size_t>(-1);
+            double      sum     = 0;
+
+            for (auto& s : samples) {
+                auto index = static_cast<std::size_t>((s.time - first) / width);
+
+                if (index != current) {
+                    if (!out.empty()) out.back().mean = sum / out.back().count;
+                    out.push_back({first + width * static_cast<std::int64_t>(index),
+                                   s.value, s.value, 0, 0});
+                    current = index;
+                    sum     = 0;
+                    }
+                auto& b = out.back();
+
+                b.min  = std::min(b.min, s.value);
+                b.max  = std::max(b.max, s.value);
+                sum   += static_cast<double>(s.value);
+                ++b.count;
+                }
+            out.back().mean = sum / out.back().count;
+            }
+
+
+        /**
+         * @brief A fixed-capacity ring of timestamped samples. Recording never
+         * allocates, and once the ring is full each new sample replaces the
+         * oldest. Samples are recorded by one writer thread at a time, while
+         * any thread may take a snapshot without locking; a snapshot omits any
+         * sample that was overwritten while it was being read.
+         *
+         * @tparam T The value type. Must be arithmetic.
+         */
+        template <typename T>
+        requires std::is_arithmetic_v<T> && std::atomic<T>::is_always_lock_free
+        class timeseries {
+        public:
+            using clock_type = std::chrono::steady_clock;
+            using time_point = clock_type::time_point;
+
+        private:
+            struct slot {
+                std::atomic<clock_type::rep> time;
+                std::atomic<T> value;
+            };
+
+
+            std::unique_ptr<slot[]> _slots;
+            std::size_t _capacity;
+            std::atomic<std::uint64_t> _started {0};
+            std::atomic<std::uint64_t> _written {0};
+            // disconnects from the tracked property, whose threading policy
+            // decides the connection type
+            std::function<void()> _disconnect;
+
+        public:
+            /**
+             * @brief Creates a timeseries that holds up to the given number of
+             * samples.
+             */
+            explicit timeseries(
+                std::size_t capacity
+                )
+                : _slots(new slot[std::max<std::size_t>(capacity, 1)])
+                , _capacity(std::max<std::size_t>(capacity, 1))
+                {
+                }
+
+            timeseries(timeseries const&)            = delete;
+            timeseries& operator=(timeseries const&) = delete;
+
+            ~timeseries()
+                {
+                untrack();
+                }
+
+            /**
+             * @brief Gets the maximum number of samples held.
+             */
+            std::size_t capacity() const
+                {
+                return _capacity;
+                }
+
+            /**
+             * @brief Gets the number of samples held.
+             */
+            std::size_t size() const
+                {
+                return static_cast<std::size_t>(
+                    std::min<std::uint64_t>(_written.load(std::memory_order_acquire), _capacity));
+                }
+
+            /**
+             * @brief Records a sample, replacing the oldest if the ring is full.
+             */
+            void record(
+                T          value,
+                time_point time = clock_type::now()
+                )
+                {
+                auto index = _written.load(std::memory_order_relaxed);
+                auto& s    = _slots[index % _capacity];
+
+                _started.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                s.time.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+                s.value.store(value, std::memory_order_relaxed);
+                _written.store(index + 1, std::memory_order_release);
+                }
+
+            /**
+             * @brief Records a sample each time the given property emits
+             * Changed, replacing any property tracked before.
+             */
+            template <typename Prop>
+            requires requires(Prop& p) { p.Changed; }
+            void track(
+                Prop& prop
+                )
+                {
+                untrack();
+                auto c = prop.Changed.connect([this](auto const& v)
+                    {
+                    record(static_cast<T>(v));
+                    });
+                _disconnect = [c]() mutable
+                    {
+                    c.disconnect();
+                    };
+                }
+
+            /**
+             * @brief Stops recording the tracked property, if any.
+             */
+            void untrack()
+                {
+                if (auto d = std::exchange(_disconnect, nullptr)) d();
+                }
+
+            /**
+             * @brief Copies the recent samples, oldest first.
+             *
+             * @param out The list that receives the samples. Its contents are
+             * replaced.
+             * @param since Samples recorded before this time are skipped.
+             */
+            void snapshot(
+                std::vector<sample<T>>& out,
+                time_point              since = time_point::min()
+                ) const
+                {
+                out.clear();
+                auto end   = _written.load(std::memory_order_acquire);
+                auto begin = end > _capacity ? end - _capacity : 0;
+
+                for (auto i = begin; i < end; ++i) {
+                    auto& s = _slots[i % _capacity];
+                    out.push_back({time_point(clock_type::duration(s.time.load(std::memory_order_relaxed))),
+                                   s.value.load(std::memory_order_relaxed)});
+                    }
+
+                // drop the samples whose slots the writer has started reusing
+                std::atomic_thread_fence(std::memory_order_acquire);
+                auto started = _started.load(std::memory_order_relaxed);
+                auto valid   = started > _capacity ? started - _capacity : 0;
+
+                if (valid > begin) {
+                    out.erase(out.begin(), out.begin() + std::min<std::uint64_t>(valid - begin, out.size()));
+                    }
+                auto first = std::find_if(out.begin(), out.end(), [&](sample<T> const& s)
+                    {
+                    return s.time >= since;
+                    });
+                out.erase(out.begin(), first);
+                }
+        };
+        }
+    }
+#endif
@@ -0,0 +1,154 @@
+/*
+ * A property that announces changes before they are made, so they can be
+ * vetoed, and reports the value it replaced along with the new one.
+ * Author: mousebyte (ateague063@gmail.com)
+ * */
+
+#ifndef MB_MEMPROP_VETOABLE_HPP
+#define MB_MEMPROP_VETOABLE_HPP
+#include <utility>
+#include <memprop/memprop.hpp>
+
+namespace mousebyte {
+    namespace memprop {
+        /**
+         * @brief Passed to the slots of a Changing signal, any of which may
+         * cancel the change.
+         */
+        class change_veto {
+            bool _canceled = false;
+
+        public:
+            /**
+             * @brief Cancels the change. The property keeps its value, and
+             * the remaining slots are still invoked.
+             */
+            void cancel() noexcept
+                {
+                _canceled = true;
+                }
+
+            /**
+             * @brief Checks whether a slot has canceled the change.
+             */
+            bool canceled() const noexcept
+                {
+                return _canceled;
+                }
+        };
+
+
+        template <typename Owner, typename V, detail::ThreadingPolicy Policy>
+        class vetoable_property;
+
+        namespace detail {
+            template <typename Owner, typename V, detail::ThreadingPolicy Policy>
+            struct property_traits<vetoable_property<Owner, V, Policy>> {
+                using owner_type      = Owner;
+                using property_type   = vetoable_property<Owner, V, Policy>;
+                using value_type      = std::remove_cvref_t<V>;
+                using const_reference = value_type const&;
+                using policy_type     = Policy;
+            };
+            }
+
+
+        /**
+         * @brief Exposes a public property whose changes are announced by
+         * Changing before they are made, and reported with the old value by
+         * Replaced. The old value is moved out of the property rather than
+         * copied, and only lives until Replaced returns.
+         *
+         * Only changes made through the setter, by assignment, bindings or
+         * patches, are announced and can be vetoed. Values replayed by silent
+         * sets such as animation frames, by snapshot restores, and by undo
+         * and redo are stored without emitting Changing or Replaced.
+         *
+         * @tparam Owner The type that contains the property.
+         * @tparam V The value type.
+         * @tparam Policy The threading policy, thread_safe or single_threaded.
+         */
+        template <typename Owner, typename V, detail::ThreadingPolicy Policy = thread_safe>
+        class vetoable_property
+            : public public_property_base<vetoable_property<Owner, V, Policy>> {
+            using my_type = vetoable_property<Owner, V, Policy>;
+
+            friend Owner;
+        public:
+            using value_type      = detail::traits::value_type<my_type>;
+            using const_reference = detail::traits::const_reference<my_type>;
+
+            /**
+             * @brief Emitted with the current and proposed values before the
+             * property is set. Slots can cancel the change through the veto.
+             */
+            typename Policy::template signal<vetoable_property, const_reference, const_reference,
+                                             change_veto&> Changing;
+
+            /**
+             * @brief Emitted with the old and new values once the new value is
+             * stored, before Changed.
+             */
+            typename Policy::template signal<vetoable_property, const_reference, const_reference> Replaced;
+
+            vetoable_property(
+                Owner* owner
+                )
+                : public_property_base<my_type>(owner)
+                , _value()
+                {
+                }
+
+            vetoable_property(
+                Owner*          owner,
+                const_reference v
+                )
+                : public_property_base<my_type>(owner)
+                , _value(v)
+                {
+                }
+
+            my_type& operator=(
+                const_reference rhs
+                )
+                {
+                this->set(rhs);
+                return *this;
+                }
+
+        protected:
+            const_reference get() const override
+                {
+                return _value;
+                }
+
+        private:
+            bool do_set(
+                const_reference v
+                ) override
+                {
+                auto self = static_cast<detail::settable_prop<my_type> const*>(this);
+
+                if (detail::replay_frame::take(self)) {
+                    _value = v;
+                    return true;
+                    }
+                change_veto veto;
+
+                Changing(_value, v, veto);
+                if (veto.canceled()) return false;
+
+                // copied before the old value is moved out, so a throwing copy
+                // or a v referring to the value leaves the value intact
+                value_type next = v;
+                value_type old  = std::exchange(_value, std::move(next));
+
+                Replaced(old, _value);
+                return true;
+                }
+
+            value_type _value;
+        };
+        }
+    }
+#endif
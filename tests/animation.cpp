@@ -0,0 +1,122 @@
+#include "memprop/animation.hpp"
+#include "catch2/catch_test_macros.hpp"
+using namespace mousebyte::memprop;
+using namespace std::chrono_literals;
+
+namespace {
+    class sprite {
+    public:
+        public_property<sprite, float> X {this, 0.0f};
+        public_property<sprite, float> Opacity {this, 1.0f};
+        public_property<sprite, int> Frame {this, 0};
+    };
+    }
+
+
+TEST_CASE("A ticker interpolates animated properties") {
+    ticker::time_point now {};
+    ticker             t([&]
+        {
+        return now;
+        });
+    sprite             s;
+
+    t.animate(s.X, 100.0f, 1s);
+    t.animate(s.Frame, 10, 2s, &ease::in_quad);
+    REQUIRE(t.size() == 2);
+    REQUIRE(t.animating(s.X));
+    REQUIRE_FALSE(t.animating(s.Opacity));
+
+    now += 500ms;
+    t.tick();
+    REQUIRE(s.X == 50.0f);
+    REQUIRE(s.Frame == 1);
+
+    now += 500ms;
+    t.tick();
+    REQUIRE(s.X == 100.0f);
+    REQUIRE(s.Frame == 3);
+    REQUIRE_FALSE(t.animating(s.X));
+    REQUIRE(t.size() == 1);
+
+    REQUIRE(t.cancel(s.Frame));
+    REQUIRE(t.size() == 0);
+    }
+
+TEST_CASE("A ticker notifies after every animated value is set") {
+    ticker::time_point now {};
+    ticker             t([&]
+        {
+        return now;
+        });
+    sprite             s;
+    auto               notified = 0;
+    auto               opacity  = 1.0f;
+
+    s.X.Changed.connect([&](float const&)
+        {
+        ++notified;
+        opacity = s.Opacity;
+        });
+    t.animate(s.X, 10.0f, 1s);
+    t.animate(s.Opacity, 0.0f, 1s);
+    now += 500ms;
+    t.tick();
+    REQUIRE(notified == 1);
+    REQUIRE(opacity == 0.5f);
+
+    SECTION("Animating a property again replaces its animation") {
+        t.animate(s.X, 0.0f, 1s);
+        REQUIRE(t.size() == 2);
+        now += 1s;
+        t.tick();
+        REQUIRE(s.X == 0.0f);
+        }
+    }
+
+TEST_CASE("Canceling an animation from a slot keeps the frame's notifications") {
+    ticker::time_point now {};
+    ticker             t([&]
+        {
+        return now;
+        });
+    sprite             s;
+    auto               opacityChanges = 0;
+    auto               frameChanges   = 0;
+
+    s.X.Changed.connect([&](float const&)
+        {
+        t.cancel(s.X);
+        });
+    s.Opacity.Changed.connect([&](float const&)
+        {
+        ++opacityChanges;
+        });
+    s.Frame.Changed.connect([&](int const&)
+        {
+        ++frameChanges;
+        });
+    // canceling X used to move the last animation, Opacity, to an index
+    // already visited
+    t.animate(s.X, 10.0f, 1s);
+    t.animate(s.Frame, 2, 1s);
+    t.animate(s.Opacity, 0.0f, 1s);
+
+    now += 100ms;
+    t.tick();
+    REQUIRE(opacityChanges == 1);
+    REQUIRE_FALSE(t.animating(s.X));
+    REQUIRE(t.animating(s.Frame));
+    REQUIRE(t.size() == 2);
+
+    // Frame still rounds to 0, so it is not notified
+    REQUIRE(frameChanges == 0);
+    now += 200ms;
+    t.tick();
+    REQUIRE(s.Frame == 1);
+    REQUIRE(frameChanges == 1);
+    now += 100ms;
+    t.tick();
+    REQUIRE(frameChanges == 1);
+    REQUIRE(opacityChanges == 3);
+    }
@@ -0,0 +1,137 @@
+#include "memprop/async.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+using namespace mousebyte::memprop;
+
+namespace {
+    class shaper {
+        int _input = 0;
+
+        int measure() const
+            {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            return _input * 2;
+            }
+
+        std::function<int()> measure_squared() const
+            {
+            return [input = _input]
+                {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                if (input < 0) throw std::domain_error("negative input");
+                return input * input;
+                };
+            }
+
+    public:
+        async_computed_property<shaper, int, &shaper::measure> Width;
+        async_computed_property<shaper, int, &shaper::measure_squared> Area;
+
+        explicit shaper(
+            async_context& context
+            )
+            : Width(this, context, -1)
+            , Area(this, context, -1)
+            {
+            }
+
+        void set_input(
+            int input
+            )
+            {
+            _input = input;
+            Area.invalidate();
+            }
+    };
+
+
+    template <typename Prop>
+    void wait_for(
+        async_context& context,
+        Prop&          prop
+        )
+        {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while (prop.pending() && std::chrono::steady_clock::now() < deadline) {
+            context.poll();
+            std::this_thread::yield();
+            }
+        }
+    }
+
+
+TEST_CASE("Async computed properties are computed on a worker thread") {
+    async_context context(1);
+    shaper        s(context);
+    auto          changes = 0;
+
+    s.Area.Changed.connect([&](int const&)
+        {
+        ++changes;
+        });
+    REQUIRE(s.Area == -1);
+    REQUIRE_FALSE(s.Area.pending());
+
+    s.set_input(3);
+    REQUIRE(s.Area.pending());
+    REQUIRE(s.Area == -1);
+    wait_for(context, s.Area);
+    REQUIRE(s.Area == 9);
+    REQUIRE(changes == 1);
+
+    SECTION("Superseded computations are discarded") {
+        s.set_input(4);
+        s.set_input(5);
+        s.set_input(6);
+        wait_for(context, s.Area);
+        REQUIRE(s.Area == 36);
+        REQUIRE(changes == 2);
+        }
+
+    SECTION("Getters without a function object run on the worker") {
+        s.Width.invalidate();
+        wait_for(context, s.Width);
+        REQUIRE(s.Width == 6);
+        }
+
+    SECTION("Exceptions thrown by getters are handed to the owner's thread") {
+        s.set_input(-1);
+        wait_for(context, s.Area);
+        REQUIRE(s.Area.error());
+        REQUIRE(s.Area == 9);
+        REQUIRE(changes == 1);
+        s.set_input(2);
+        wait_for(context, s.Area);
+        REQUIRE_FALSE(s.Area.error());
+        REQUIRE(s.Area == 4);
+        }
+    }
+
+TEST_CASE("Destroying an async computed property cancels its computation") {
+    async_context context(1);
+    {
+    shaper s(context);
+    s.set_input(2);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(context.poll() <= 1);
+    }
+
+TEST_CASE("Destroying a context waits for running jobs") {
+    std::atomic<bool> started = false;
+    {
+    async_context context(1);
+
+    context.pool().submit([&]
+        {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        context.post([] {});
+        });
+    while (!started) std::this_thread::yield();
+    }
+    REQUIRE(started);
+    }
@@ -0,0 +1,139 @@
+#include "memprop/memprop.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <atomic>
+#include <thread>
+using namespace mousebyte::memprop;
+
+namespace {
+    class sensor;
+    class atomic_property;
+    }
+
+namespace mousebyte {
+    namespace memprop {
+        namespace detail {
+            template <>
+            struct property_traits<atomic_property> {
+                using owner_type      = sensor;
+                using property_type   = atomic_property;
+                using value_type      = int;
+                using const_reference = int;
+            };
+            }
+        }
+    }
+
+namespace {
+    // A property whose value may be set from several threads at once.
+    class atomic_property
+        : public public_property_base<atomic_property> {
+        std::atomic<int> _value {0};
+
+    public:
+        atomic_property(
+            sensor* owner
+            )
+            : public_property_base<atomic_property>(owner)
+            {
+            }
+
+        atomic_property& operator=(
+            int rhs
+            )
+            {
+            this->set(rhs);
+            return *this;
+            }
+
+    protected:
+        int get() const override
+            {
+            return _value.load();
+            }
+
+    private:
+        bool do_set(
+            int v
+            ) override
+            {
+            _value.store(v);
+            return true;
+            }
+    };
+
+
+    class sensor {
+    public:
+        atomic_property Reading {this};
+        atomic_property Display {this};
+    };
+
+
+    template <typename Fn>
+    void run_concurrently(
+        Fn fn
+        )
+        {
+        std::thread other([&]
+            {
+            fn(1);
+            });
+        fn(0);
+        other.join();
+        }
+    }
+
+constexpr int iterations = 5000;
+
+TEST_CASE("Bindings propagate changes made on several threads at once") {
+    sensor           s;
+    std::atomic<int> updates = 0;
+
+    s.Display.bind(s.Reading);
+    s.Display.Changed.connect([&](int)
+        {
+        ++updates;
+        });
+
+    run_concurrently([&](int thread)
+        {
+        for (int i = 0; i < iterations; ++i) s.Reading = thread * iterations + i;
+        });
+    REQUIRE(updates == 2 * iterations);
+    }
+
+TEST_CASE("Two-way bindings suppress loops per thread") {
+    sensor           s;
+    std::atomic<int> readings = 0;
+    std::atomic<int> displays = 0;
+    auto             binding  = bind_two_way(s.Display, s.Reading, sync_direction::none);
+
+    s.Reading.Changed.connect([&](int)
+        {
+        ++readings;
+        });
+    s.Display.Changed.connect([&](int)
+        {
+        ++displays;
+        });
+
+    run_concurrently([&](int thread)
+        {
+        auto& prop = thread ? s.Display : s.Reading;
+
+        for (int i = 0; i < iterations; ++i) prop = i;
+        });
+    REQUIRE(readings == 2 * iterations);
+    REQUIRE(displays == 2 * iterations);
+    }
+
+TEST_CASE("Setters on several threads each advance the version") {
+    sensor s;
+    auto   start = s.Reading.version();
+
+    run_concurrently([&](int thread)
+        {
+        for (int i = 0; i < iterations; ++i) s.Reading = thread * iterations + i;
+        });
+    REQUIRE(s.Reading.version() - start == 2 * iterations);
+    }
@@ -0,0 +1,101 @@
+#include "memprop/coro.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    class counter {
+    public:
+        public_property<counter, int> Value {this, 0};
+        readonly_property<counter, bool> Done {this, false};
+
+        void finish()
+            {
+            Done = true;
+            }
+    };
+
+
+    task await_value(
+        counter& c,
+        int&     out
+        )
+        {
+        out = co_await c.Value.next_change();
+        }
+
+    task await_on(
+        counter&  c,
+        executor& e,
+        int&      out
+        )
+        {
+        out = co_await c.Value.next_change(&e);
+        }
+
+    task collect(
+        counter&          c,
+        std::vector<int>& out
+        )
+        {
+        auto stream = c.Value.changes();
+
+        while (out.size() < 3) out.push_back(co_await stream.next());
+        }
+    }
+
+
+TEST_CASE("The next change of a property can be awaited") {
+    counter c;
+    int     value = -1;
+
+    SECTION("Resumes from within the setter") {
+        auto t = await_value(c, value);
+        REQUIRE_FALSE(t.done());
+        c.Value = 7;
+        REQUIRE(t.done());
+        REQUIRE(value == 7);
+        }
+
+    SECTION("Resumes on an executor") {
+        manual_executor exec;
+        auto            t = await_on(c, exec, value);
+        c.Value = 3;
+        REQUIRE_FALSE(t.done());
+        REQUIRE(exec.run() == 1);
+        REQUIRE(t.done());
+        REQUIRE(value == 3);
+        }
+
+    SECTION("Destroying a waiting coroutine removes its waiter") {
+        {
+        auto t = await_value(c, value);
+        }
+        c.Value = 1;
+        REQUIRE(value == -1);
+        }
+
+    SECTION("Readonly properties can be awaited") {
+        auto done = [](counter& c, bool& out) -> task
+            {
+            out = co_await c.Done.next_change();
+            };
+        auto finished = false;
+        auto t        = done(c, finished);
+        c.finish();
+        REQUIRE(finished);
+        }
+    }
+
+TEST_CASE("A stream of property changes can be awaited repeatedly") {
+    counter          c;
+    std::vector<int> values;
+    auto             t = collect(c, values);
+
+    c.Value = 1;
+    c.Value = 2;
+    REQUIRE(values == std::vector<int> {1, 2});
+    c.Value = 3;
+    REQUIRE(t.done());
+    REQUIRE(values == std::vector<int> {1, 2, 3});
+    }
@@ -0,0 +1,106 @@
+#include "memprop/fanout.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <stdexcept>
+using namespace mousebyte::memprop;
+
+namespace {
+    class theme {
+    public:
+        public_property<theme, int> Accent {this, 0};
+        public_property<theme, int, nullptr, single_threaded> Contrast {this, 0};
+    };
+    }
+
+
+TEST_CASE("Parallel fan-out runs every subscriber before the setter returns") {
+    fanout_pool             pool(3);
+    theme                   t;
+    parallel_fanout<int>    fanout(t.Accent, pool, 64, 16);
+    std::vector<int>        seen(1000, 0);
+    std::atomic<std::size_t> threads = 0;
+    auto                    setter = std::this_thread::get_id();
+
+    for (std::size_t i = 0; i < seen.size(); ++i) {
+        fanout.connect([&, i](int const& v)
+            {
+            seen[i] = v;
+            if (std::this_thread::get_id() != setter) ++threads;
+            }, dispatch::parallel_safe);
+        }
+    std::vector<int> order;
+    fanout.connect([&](int const&)
+        {
+        REQUIRE(std::this_thread::get_id() == setter);
+        order.push_back(1);
+        });
+    auto second = fanout.connect([&](int const&)
+        {
+        order.push_back(2);
+        });
+    REQUIRE(fanout.size() == 1002);
+
+    t.Accent = 5;
+    REQUIRE(std::count(seen.begin(), seen.end(), 5) == 1000);
+    REQUIRE(order == std::vector<int> {1, 2});
+
+    REQUIRE(fanout.disconnect(second));
+    REQUIRE_FALSE(fanout.disconnect(second));
+    t.Accent = 6;
+    REQUIRE(std::count(seen.begin(), seen.end(), 6) == 1000);
+    REQUIRE(order == std::vector<int> {1, 2, 1});
+    }
+
+TEST_CASE("Parallel fan-out runs serially below its threshold") {
+    fanout_pool          pool(2);
+    theme                t;
+    parallel_fanout<int> fanout(t.Accent, pool, 100);
+    auto                 setter  = std::this_thread::get_id();
+    auto                 onOther = 0;
+
+    for (int i = 0; i < 10; ++i) {
+        fanout.connect([&](int const&)
+            {
+            if (std::this_thread::get_id() != setter) ++onOther;
+            }, dispatch::parallel_safe);
+        }
+    t.Accent = 1;
+    REQUIRE(onOther == 0);
+    }
+
+TEST_CASE("Parallel fan-out rethrows subscriber exceptions on the setter") {
+    fanout_pool          pool(2);
+    theme                t;
+    parallel_fanout<int> fanout(t.Accent, pool, 1, 1);
+    std::atomic<int>     calls = 0;
+
+    for (int i = 0; i < 8; ++i) {
+        fanout.connect([&, i](int const&)
+            {
+            ++calls;
+            if (i == 3) throw std::runtime_error("subscriber failed");
+            }, dispatch::parallel_safe);
+        }
+    REQUIRE_THROWS(t.Accent = 1);
+    REQUIRE(calls == 8);
+    }
+
+TEST_CASE("Parallel fan-out dispatches single-threaded properties") {
+    fanout_pool      pool(2);
+    theme            t;
+    std::vector<int> seen(100, 0);
+    {
+    parallel_fanout<int> fanout(t.Contrast, pool, 10, 10);
+
+    for (std::size_t i = 0; i < seen.size(); ++i) {
+        fanout.connect([&, i](int const& v)
+            {
+            seen[i] = v;
+            }, dispatch::parallel_safe);
+        }
+    t.Contrast = 3;
+    REQUIRE(std::count(seen.begin(), seen.end(), 3) == 100);
+    }
+
+    t.Contrast = 4;
+    REQUIRE(std::count(seen.begin(), seen.end(), 3) == 100);
+    }
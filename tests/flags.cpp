@@ -0,0 +1,135 @@
+#include "memprop/flags.hpp"
+#include "catch2/catch_test_macros.hpp"
+using namespace mousebyte::memprop;
+
+namespace {
+    enum class alignment {
+        start,
+        center,
+        end
+    };
+
+
+    class flag_widget {
+    public:
+        using Visible = flag<bool, 0>;
+        using Enabled = flag<bool, 1>;
+        using Hovered = flag<bool, 2>;
+        using Align   = flag<alignment, 3, 2>;
+
+        flag_group<> Flags {Visible::mask | Enabled::mask};
+    };
+
+
+    class flag_source {
+    public:
+        public_property<flag_source, bool> Active {this, false};
+        public_property<flag_source, int> Column {this, 0};
+    };
+    }
+
+
+TEST_CASE("Flags are packed into one word") {
+    flag_widget w;
+    auto        changes = 0;
+    auto        last    = std::uint64_t{0};
+
+    w.Flags.Changed.connect([&](std::uint64_t changed)
+        {
+        last = changed;
+        ++changes;
+        });
+
+    REQUIRE(w.Flags.get<flag_widget::Visible>());
+    REQUIRE_FALSE(w.Flags.get<flag_widget::Hovered>());
+    REQUIRE(w.Flags.get<flag_widget::Align>() == alignment::start);
+
+    REQUIRE(w.Flags.set<flag_widget::Align>(alignment::end));
+    REQUIRE(w.Flags.get<flag_widget::Align>() == alignment::end);
+    REQUIRE(w.Flags.get<flag_widget::Visible>());
+    REQUIRE(changes == 1);
+    REQUIRE(flag_widget::Align::in(last));
+    REQUIRE_FALSE(flag_widget::Visible::in(last));
+
+    REQUIRE_FALSE(w.Flags.set<flag_widget::Visible>(true));
+    REQUIRE(changes == 1);
+    REQUIRE(sizeof(flag_group<>) < 2 * sizeof(public_property<flag_widget, bool>));
+
+    flag_group<single_threaded> local;
+    local.set<flag_widget::Hovered>(true);
+    REQUIRE(local.bits() == flag_widget::Hovered::mask);
+    }
+
+TEST_CASE("Bulk flag updates notify once") {
+    flag_widget w;
+    auto        changes = 0;
+    auto        last    = std::uint64_t{0};
+
+    w.Flags.Changed.connect([&](std::uint64_t changed)
+        {
+        last = changed;
+        ++changes;
+        });
+
+    SECTION("Assigning several bits") {
+        auto mask = flag_widget::Visible::mask | flag_widget::Hovered::mask;
+        REQUIRE(w.Flags.assign(mask, flag_widget::Hovered::mask));
+        REQUIRE(changes == 1);
+        REQUIRE(last == mask);
+        REQUIRE_FALSE(w.Flags.get<flag_widget::Visible>());
+        REQUIRE(w.Flags.get<flag_widget::Hovered>());
+        }
+    SECTION("Batches") {
+        {
+        flag_group<>::batch batch(w.Flags);
+        w.Flags.set<flag_widget::Enabled>(false);
+        w.Flags.set<flag_widget::Align>(alignment::center);
+        w.Flags.set<flag_widget::Enabled>(true);
+        REQUIRE(changes == 0);
+        }
+        // Enabled was set back, so only the alignment is reported
+        REQUIRE(changes == 1);
+        REQUIRE(flag_widget::Align::in(last));
+        REQUIRE_FALSE(flag_widget::Enabled::in(last));
+
+        {
+        flag_group<>::batch batch(w.Flags);
+        w.Flags.set<flag_widget::Hovered>(true);
+        w.Flags.set<flag_widget::Hovered>(false);
+        }
+        REQUIRE(changes == 1);
+        }
+    }
+
+TEST_CASE("Flags can be bound to properties") {
+    flag_widget w;
+    flag_source s;
+
+    auto binding = w.Flags.bind<flag_widget::Hovered>(s.Active);
+    REQUIRE_FALSE(w.Flags.get<flag_widget::Hovered>());
+    s.Active = true;
+    REQUIRE(w.Flags.get<flag_widget::Hovered>());
+
+    w.Flags.bind<flag_widget::Align>(s.Column, [](int const& c)
+        {
+        return static_cast<alignment>(c % 3);
+        });
+    s.Column = 4;
+    REQUIRE(w.Flags.get<flag_widget::Align>() == alignment::center);
+
+    SECTION("Rebinding replaces the previous binding") {
+        flag_source other;
+        w.Flags.bind<flag_widget::Hovered>(other.Active);
+        REQUIRE_FALSE(binding->active());
+        REQUIRE_FALSE(w.Flags.get<flag_widget::Hovered>());
+        s.Active = true;
+        REQUIRE_FALSE(w.Flags.get<flag_widget::Hovered>());
+        }
+    SECTION("Unbinding") {
+        w.Flags.unbind<flag_widget::Align>();
+        s.Column = 5;
+        REQUIRE(w.Flags.get<flag_widget::Align>() == alignment::center);
+        s.Active = false;
+        REQUIRE_FALSE(w.Flags.get<flag_widget::Hovered>());
+        }
+    }
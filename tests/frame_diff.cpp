@@ -0,0 +1,111 @@
+#include "memprop/frame_diff.hpp"
+#include "memprop/table.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <cmath>
+#include <limits>
+using namespace mousebyte::memprop;
+
+namespace {
+    template <typename T>
+    std::vector<std::uint32_t> reference_diff(
+        std::vector<T> const& a,
+        std::vector<T> const& b
+        )
+        {
+        std::vector<std::uint32_t> out;
+
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            if (i >= a.size() || std::memcmp(&a[i], &b[i], sizeof(T)) != 0) out.push_back(i);
+            }
+        return out;
+        }
+
+    template <typename T>
+    void check_diff()
+        {
+        for (std::size_t size : {0, 1, 7, 31, 64, 65, 200, 1027}) {
+            std::vector<T> a(size), b(size);
+
+            for (std::size_t i = 0; i < size; ++i) {
+                a[i] = b[i] = static_cast<T>(i % 100);
+                if (i % 13 == 5 || i % 64 == 63) b[i] = static_cast<T>(b[i] + 1);
+                }
+            changed_bitset             bits;
+            std::vector<std::uint32_t> indices;
+
+            diff(std::span<T const>(a), std::span<T const>(b), bits, indices);
+            REQUIRE(indices == reference_diff(a, b));
+            REQUIRE(bits.count() == indices.size());
+
+            changed_bitset scalar;
+            scalar.reset(size);
+            detail::diff_kernel<T, 8>(a.data(), b.data(), size, scalar.words().data());
+            REQUIRE(std::ranges::equal(scalar.words(), bits.words()));
+            }
+        }
+    }
+
+
+TEST_CASE("Diffs report exactly the changed indices") {
+    check_diff<std::int8_t>();
+    check_diff<std::uint16_t>();
+    check_diff<int>();
+    check_diff<float>();
+    check_diff<double>();
+    }
+
+TEST_CASE("Diffs compare values bitwise") {
+    auto                nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> a {nan, 0.0f, 1.0f};
+    std::vector<float> b {nan, -0.0f, 1.0f, 2.0f};
+    changed_bitset      bits;
+
+    diff(std::span<float const>(a), std::span<float const>(b), bits);
+    REQUIRE_FALSE(bits.test(0));
+    REQUIRE(bits.test(1));
+    REQUIRE_FALSE(bits.test(2));
+    REQUIRE(bits.test(3));
+    }
+
+namespace {
+    class diff_widget {
+    public:
+        static inline property_table<diff_widget, float> opacity_table;
+        table_property<diff_widget, float> Opacity {this, opacity_table};
+        public_property<diff_widget, int> Index {this};
+    };
+    }
+
+
+TEST_CASE("Snapshots find values changed between captures") {
+    std::vector<std::unique_ptr<diff_widget>> widgets;
+
+    for (auto i = 0; i < 100; ++i) {
+        widgets.push_back(std::make_unique<diff_widget>());
+        }
+
+    SECTION("Snapshots can capture table values") {
+        numeric_snapshot<float> snapshot;
+        snapshot.capture(diff_widget::opacity_table.values());
+        REQUIRE(snapshot.changed().count() == 100);
+        widgets[3]->Opacity  = 0.5f;
+        widgets[70]->Opacity = 0.25f;
+        snapshot.capture(diff_widget::opacity_table.values());
+        std::vector<std::uint32_t> changed;
+        snapshot.changed(changed);
+        REQUIRE(changed == std::vector<std::uint32_t> {3, 70});
+        }
+    SECTION("Snapshots can capture properties") {
+        numeric_snapshot<int> snapshot;
+        auto                  props = widgets | std::views::transform([](auto& w)
+            {
+            return &w->Index;
+            });
+        snapshot.capture(props);
+        widgets[99]->Index = 4;
+        snapshot.capture(props);
+        REQUIRE(snapshot.changed().count() == 1);
+        REQUIRE(snapshot.changed().test(99));
+        REQUIRE(snapshot.values()[99] == 4);
+        }
+    }
@@ -0,0 +1,125 @@
+#include "memprop/history.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include <string>
+using namespace mousebyte::memprop;
+
+namespace {
+    class document
+        : public history_tracking {
+    public:
+        public_property<document, int> Width {this, 0};
+        public_property<document, int> Height {this, 0};
+        public_property<document, std::string> Title {this};
+    };
+    }
+
+
+TEST_CASE("Property history records old and new values") {
+    property_history history(4096);
+    document         doc;
+
+    doc.Width = 1;
+    doc.record_history(&history);
+    REQUIRE_FALSE(history.can_undo());
+
+    SECTION("Sets can be undone and redone") {
+        doc.Width = 5;
+        history.seal();
+        doc.Title = "draft";
+        REQUIRE(history.size() == 2);
+
+        auto changes = 0;
+        doc.Width.Changed.connect([&](int const&)
+            {
+            ++changes;
+            });
+        REQUIRE(history.undo());
+        REQUIRE_THAT(doc.Title, Catch::Matchers::Equals(""));
+        REQUIRE(history.undo());
+        REQUIRE(doc.Width == 1);
+        REQUIRE(changes == 1);
+        REQUIRE_FALSE(history.undo());
+        REQUIRE(history.size() == 2);
+
+        REQUIRE(history.redo());
+        REQUIRE(doc.Width == 5);
+        REQUIRE(history.redo());
+        REQUIRE_THAT(doc.Title, Catch::Matchers::Equals("draft"));
+        REQUIRE_FALSE(history.can_redo());
+        REQUIRE(changes == 2);
+        }
+
+    SECTION("Consecutive sets of a property are merged") {
+        for (int i = 2; i < 10; ++i) doc.Width = i;
+        REQUIRE(history.size() == 1);
+        history.seal();
+        doc.Width = 20;
+        REQUIRE(history.size() == 2);
+        history.undo();
+        REQUIRE(doc.Width == 9);
+        history.undo();
+        REQUIRE(doc.Width == 1);
+        }
+
+    SECTION("Grouped sets are undone together") {
+        {
+        history_group group(history);
+        doc.Width  = 3;
+        doc.Height = 4;
+        }
+        doc.Title = "sized";
+        history.undo();
+        REQUIRE(doc.Width == 3);
+        history.undo();
+        REQUIRE(doc.Width == 1);
+        REQUIRE(doc.Height == 0);
+        history.redo();
+        REQUIRE(doc.Width == 3);
+        REQUIRE(doc.Height == 4);
+        }
+
+    SECTION("Setting after an undo discards the redo records") {
+        doc.Width = 2;
+        history.undo();
+        doc.Height = 7;
+        REQUIRE_FALSE(history.can_redo());
+        REQUIRE(history.size() == 1);
+        }
+    }
+
+TEST_CASE("Property history evicts the oldest records when full") {
+    property_history history(512);
+    document         doc;
+
+    doc.record_history(&history);
+    for (int i = 1; i <= 100; ++i) {
+        doc.Width = i;
+        history.seal();
+        }
+    REQUIRE(history.size() < 100);
+    REQUIRE(history.size() > 0);
+
+    auto undone = 0;
+    while (history.undo()) ++undone;
+    REQUIRE(undone == static_cast<int>(history.size()));
+    REQUIRE(doc.Width == 100 - undone);
+    }
+
+TEST_CASE("Property history discards the records of destroyed owners") {
+    property_history history(4096);
+    document         kept;
+
+    kept.record_history(&history);
+    kept.Width = 1;
+    {
+    document temp;
+    temp.record_history(&history);
+    temp.Width = 2;
+    history.seal();
+    REQUIRE(history.size() == 2);
+    }
+    REQUIRE(history.size() == 1);
+    history.undo();
+    REQUIRE(kept.Width == 0);
+    }
@@ -0,0 +1,97 @@
+#include "memprop/interned.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <thread>
+#include <unordered_set>
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    class styled_widget {
+    public:
+        interned_property<styled_widget> Style {this, "plain"};
+        public_property<styled_widget, int> Width {this, 0};
+
+        using properties = property_list<styled_widget,
+                                         property_entry<"Style", &styled_widget::Style>,
+                                         property_entry<"Width", &styled_widget::Width>>;
+    };
+    }
+
+
+TEST_CASE("Interned strings share one copy of each string") {
+    interned_string a("button");
+    interned_string b(std::string("but") + "ton");
+    interned_string c = std::string_view("label");
+    interned_string empty;
+
+    REQUIRE(a == b);
+    REQUIRE(a.c_str() == b.c_str());
+    REQUIRE_FALSE(a == c);
+    REQUIRE(a == "button");
+    REQUIRE(c == std::string_view("label"));
+    REQUIRE(empty.empty());
+    REQUIRE(empty == interned_string(""));
+    REQUIRE(std::hash<interned_string>{}(a) == std::hash<interned_string>{}(b));
+
+    auto size = interned_string::pool_size();
+    interned_string again("label");
+    REQUIRE(interned_string::pool_size() == size);
+
+    std::unordered_set<interned_string> set {a, b, c};
+    REQUIRE(set.size() == 2);
+    }
+
+TEST_CASE("Strings can be interned from several threads") {
+    std::vector<std::thread>                   threads;
+    std::vector<std::vector<interned_string>> results(4);
+
+    for (auto t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]
+            {
+            for (auto i = 0; i < 200; ++i) {
+                results[t].emplace_back("thread-key-" + std::to_string(i % 50));
+                }
+            });
+        }
+    for (auto& thread : threads) thread.join();
+    for (auto t = 1; t < 4; ++t) REQUIRE(results[t] == results[0]);
+    }
+
+TEST_CASE("Interned properties only notify when the string changes") {
+    styled_widget w;
+    auto          changes = 0;
+    std::string   seen;
+
+    w.Style.Changed.connect([&](interned_string const& s)
+        {
+        seen = s.view();
+        ++changes;
+        });
+    REQUIRE(w.Style == "plain");
+    REQUIRE(w.Style.view() == "plain");
+
+    w.Style = "bold";
+    REQUIRE(changes == 1);
+    REQUIRE(seen == "bold");
+    w.Style = std::string("bo") + "ld";
+    REQUIRE(changes == 1);
+    w.Style = interned_string("plain");
+    REQUIRE(changes == 2);
+
+    std::string_view view = w.Style;
+    REQUIRE(view == "plain");
+    }
+
+TEST_CASE("Interned properties are saved as text") {
+    styled_widget src;
+    src.Style = "saved-style";
+    src.Width = 7;
+    std::vector<std::byte> data;
+    save_snapshot(src, data);
+
+    styled_widget dst;
+    REQUIRE(restore_snapshot(dst, data) == snapshot_status::ok);
+    REQUIRE(dst.Style == "saved-style");
+    REQUIRE(static_cast<interned_string const&>(dst.Style) == src.Style);
+    REQUIRE(dst.Width == 7);
+    }
@@ -0,0 +1,107 @@
+#include "memprop/lazy.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    class model {
+    public:
+        public_property<model, int> Count {this, 0};
+    };
+
+
+    class label
+        : public relocatable {
+    public:
+        lazy_property<label, std::string> Text {this};
+        lazy_property<label, int, single_threaded> Count {this, -1};
+    };
+    }
+
+
+TEST_CASE("Lazy properties convert their source when read") {
+    model m;
+    label l;
+    auto  conversions   = 0;
+    auto  invalidations = 0;
+
+    l.Text.Invalidated.connect([&]
+        {
+        ++invalidations;
+        });
+    l.Text.bind(m.Count, [&](int const& c)
+        {
+        ++conversions;
+        return std::to_string(c) + " items";
+        });
+    REQUIRE(invalidations == 1);
+    REQUIRE(conversions == 0);
+    REQUIRE(l.Text.stale());
+    REQUIRE_THAT(l.Text, Catch::Matchers::Equals("0 items"));
+    REQUIRE(conversions == 1);
+    REQUIRE_FALSE(l.Text.stale());
+
+    m.Count = 1;
+    m.Count = 2;
+    m.Count = 3;
+    REQUIRE(conversions == 1);
+    REQUIRE(invalidations == 2);
+    REQUIRE_THAT(l.Text, Catch::Matchers::Equals("3 items"));
+    REQUIRE_THAT(l.Text, Catch::Matchers::Equals("3 items"));
+    REQUIRE(conversions == 2);
+
+    m.Count = 4;
+    REQUIRE(invalidations == 3);
+
+    SECTION("Unbinding keeps the latest value") {
+        l.Text.unbind();
+        REQUIRE(conversions == 3);
+        m.Count = 5;
+        REQUIRE(invalidations == 3);
+        REQUIRE_THAT(l.Text, Catch::Matchers::Equals("4 items"));
+        REQUIRE_FALSE(l.Text.stale());
+        }
+    SECTION("Disconnecting the binding keeps the last value read") {
+        auto b = l.Count.bind(m.Count);
+        REQUIRE(l.Count == 4);
+        b->disconnect();
+        m.Count = 9;
+        REQUIRE_FALSE(l.Count.stale());
+        REQUIRE(l.Count == 4);
+        }
+    SECTION("Destroying the source keeps the last value read") {
+        auto other = std::make_unique<model>();
+        l.Count.bind(other->Count);
+        other->Count = 7;
+        REQUIRE(l.Count == 7);
+        other->Count = 8;
+        other.reset();
+        REQUIRE_FALSE(l.Count.stale());
+        REQUIRE(l.Count == 7);
+        }
+    }
+
+TEST_CASE("Lazy bindings follow relocated properties") {
+    model              m;
+    std::vector<label> labels;
+
+    labels.reserve(1);
+    labels.emplace_back();
+    labels[0].Count.bind(m.Count);
+    REQUIRE(labels[0].Count == 0);
+    auto invalidations = 0;
+
+    labels[0].Count.Invalidated.connect([&]
+        {
+        ++invalidations;
+        });
+
+    for (auto i = 0; i < 10; ++i) labels.emplace_back();
+
+    m.Count = 6;
+    REQUIRE(invalidations == 1);
+    REQUIRE(labels[0].Count == 6);
+    }
@@ -0,0 +1,143 @@
+#include "memprop/mapped.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <filesystem>
+#include <fstream>
+using namespace mousebyte::memprop;
+
+namespace {
+    struct settings_data {
+        int volume;
+        double scale;
+        bool fullscreen;
+    };
+
+
+    class settings {
+    public:
+        mapped_region<settings_data> Data;
+        mapped_property<settings, &settings_data::volume> Volume {this, Data};
+        mapped_property<settings, &settings_data::scale> Scale {this, Data};
+        mapped_property<settings, &settings_data::fullscreen> Fullscreen {this, Data};
+
+        settings(
+            std::filesystem::path const& path,
+            std::uint32_t                schema = 1
+            )
+            : Data(path, schema, {50, 1.0, false})
+            {
+            }
+    };
+
+
+    struct temp_file {
+        std::filesystem::path path;
+
+        explicit temp_file(
+            char const* name
+            )
+            : path(std::filesystem::temp_directory_path() / name)
+            {
+            std::filesystem::remove(path);
+            }
+
+        ~temp_file()
+            {
+            std::filesystem::remove(path);
+            }
+    };
+    }
+
+
+TEST_CASE("Mapped properties persist across mappings") {
+    temp_file file("memprop_mapped_persist.bin");
+    {
+    settings s(file.path);
+    REQUIRE(s.Data.status() == mapped_status::created);
+    REQUIRE(s.Volume == 50);
+    REQUIRE(s.Scale == 1.0);
+
+    auto changes = 0;
+    s.Volume.Changed.connect([&](int const&)
+        {
+        ++changes;
+        });
+    s.Volume     = 80;
+    s.Fullscreen = true;
+    REQUIRE(changes == 1);
+    REQUIRE(s.Data.dirty());
+    REQUIRE(s.Data.sync());
+    REQUIRE_FALSE(s.Data.dirty());
+    s.Scale      = 2.5;
+    }
+
+    settings s(file.path);
+    REQUIRE(s.Data.status() == mapped_status::restored);
+    REQUIRE(s.Volume == 80);
+    REQUIRE(s.Scale == 2.5);
+    REQUIRE(s.Fullscreen);
+    REQUIRE(s.Data.data().volume == 80);
+    }
+
+TEST_CASE("Mapped regions are reset when the layout does not match") {
+    temp_file file("memprop_mapped_reset.bin");
+    {
+    settings s(file.path);
+    s.Volume = 10;
+    }
+
+    SECTION("A different schema version") {
+        settings s(file.path, 2);
+        REQUIRE(s.Data.status() == mapped_status::reset);
+        REQUIRE(s.Volume == 50);
+        }
+    SECTION("A different layout name") {
+        mapped_region<settings_data> region(file.path, "settings", 1, {50, 1.0, false});
+        REQUIRE(region.status() == mapped_status::reset);
+        REQUIRE(region.data().volume == 50);
+        }
+    SECTION("The same layout under another type") {
+        struct renamed_data {
+            int volume;
+            double scale;
+            bool fullscreen;
+        };
+
+        mapped_region<renamed_data> region(file.path, 1);
+        REQUIRE(region.status() == mapped_status::restored);
+        REQUIRE(region.data().volume == 10);
+        }
+    SECTION("A damaged file") {
+        {
+        std::ofstream out(file.path, std::ios::binary | std::ios::trunc);
+        out << "not a memprop file";
+        }
+        settings s(file.path);
+        REQUIRE(s.Data.status() == mapped_status::reset);
+        REQUIRE(s.Volume == 50);
+        s.Volume = 20;
+        }
+    }
+
+TEST_CASE("Mapped regions fall back to memory") {
+    settings s(std::filesystem::temp_directory_path() / "memprop_missing_dir" / "settings.bin");
+    REQUIRE(s.Data.status() == mapped_status::unavailable);
+    REQUIRE(s.Volume == 50);
+    s.Volume = 70;
+    REQUIRE(s.Volume == 70);
+    REQUIRE(s.Data.sync());
+    }
+
+TEST_CASE("Mapped regions sync periodically") {
+    using clock = mapped_region<settings_data>::clock_type;
+
+    temp_file file("memprop_mapped_periodic.bin");
+    settings  s(file.path);
+    auto      now = clock::now();
+
+    REQUIRE_FALSE(s.Data.sync_if_due(std::chrono::seconds(1), now + std::chrono::hours(1)));
+    s.Volume = 1;
+    REQUIRE_FALSE(s.Data.sync_if_due(std::chrono::hours(2), now + std::chrono::hours(1)));
+    REQUIRE(s.Data.dirty());
+    REQUIRE(s.Data.sync_if_due(std::chrono::seconds(1), now + std::chrono::hours(1)));
+    REQUIRE_FALSE(s.Data.dirty());
+    }
@@ -0,0 +1,135 @@
+#include "memprop/patch.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+using namespace mousebyte::memprop;
+
+namespace {
+    class patch_model {
+        bool set_count(
+            int&       o,
+            int const& v
+            )
+            {
+            if (v > 10) return false;
+            o = v;
+            return true;
+            }
+
+        int twice() const
+            {
+            return Count * 2;
+            }
+
+    public:
+        public_property<patch_model, int, &patch_model::set_count> Count {this, 0};
+        computed_property<patch_model, int, &patch_model::twice> Twice {this};
+        public_property<patch_model, std::string> Title {this};
+        readonly_property<patch_model, double> Progress {this, 0.0};
+
+        void set_progress(
+            double p
+            )
+            {
+            Progress = p;
+            }
+
+        using properties = property_list<patch_model,
+                                         property_entry<"Count", &patch_model::Count>,
+                                         property_entry<"Twice", &patch_model::Twice>,
+                                         property_entry<"Title", &patch_model::Title>,
+                                         property_entry<"Progress", &patch_model::Progress>>;
+    };
+    }
+
+
+TEST_CASE("Setting a property increments its version") {
+    patch_model m;
+
+    REQUIRE(m.Count.version() == 0);
+    m.Count = 4;
+    REQUIRE(m.Count.version() == 1);
+    m.Count = 40;
+    REQUIRE(m.Count.version() == 1);
+    m.Count = 4;
+    REQUIRE(m.Count.version() == 2);
+    }
+
+TEST_CASE("Patches hold only properties changed since a baseline") {
+    patch_model model;
+    patch_model mirror;
+    auto        baseline = capture_versions(model);
+
+    std::vector<std::byte> empty;
+    REQUIRE(make_patch(model, baseline, empty) == 0);
+
+    model.Title = "synced";
+    model.set_progress(0.5);
+    std::vector<std::byte> patch;
+    REQUIRE(make_patch(model, baseline, patch) == 2);
+
+    auto titles = 0;
+    mirror.Title.Changed.connect([&](std::string const&)
+        {
+        ++titles;
+        });
+    REQUIRE(apply_patch(mirror, patch) == snapshot_status::ok);
+    REQUIRE_THAT(mirror.Title, Catch::Matchers::Equals("synced"));
+    REQUIRE(mirror.Progress == 0.5);
+    REQUIRE(mirror.Count == 0);
+    REQUIRE(titles == 1);
+
+    baseline = capture_versions(model);
+    model.Count = 7;
+    patch.clear();
+    REQUIRE(make_patch(model, baseline, patch) == 1);
+    REQUIRE(apply_patch(mirror, patch) == snapshot_status::ok);
+    REQUIRE(mirror.Count == 7);
+    REQUIRE(mirror.Twice == 14);
+    }
+
+TEST_CASE("Applying a patch goes through the setter") {
+    patch_model model;
+    patch_model mirror;
+    auto        baseline = capture_versions(model);
+
+    model.Count = 9;
+    std::vector<std::byte> patch;
+    make_patch(model, baseline, patch);
+    mirror.Count = 3;
+    // corrupt the value so that the mirror's setter rejects it
+    auto value = 11;
+    std::memcpy(patch.data() + patch.size() - sizeof(int), &value, sizeof(int));
+    REQUIRE(apply_patch(mirror, patch) == snapshot_status::ok);
+    REQUIRE(mirror.Count == 3);
+    REQUIRE(apply_patch(mirror, std::span<std::byte const>(patch).first(patch.size() - 1))
+            == snapshot_status::truncated);
+    }
+
+TEST_CASE("Patches include properties restored without notifications") {
+    patch_model model;
+    patch_model mirror;
+
+    model.Count = 7;
+    model.Title = "restored";
+    std::vector<std::byte> data;
+    save_snapshot(model, data);
+
+    auto baseline = capture_versions(mirror);
+    auto changes  = 0;
+    mirror.Count.Changed.connect([&](int const&)
+        {
+        ++changes;
+        });
+    REQUIRE(restore_snapshot(mirror, data, restore_notify::none) == snapshot_status::ok);
+    REQUIRE(mirror.Count == 7);
+    REQUIRE(changes == 0);
+    REQUIRE(mirror.Count.version() != baseline[0]);
+
+    std::vector<std::byte> patch;
+    REQUIRE(make_patch(mirror, baseline, patch) == 3);
+
+    patch_model copy;
+    REQUIRE(apply_patch(copy, patch) == snapshot_status::ok);
+    REQUIRE(copy.Count == 7);
+    REQUIRE_THAT(copy.Title, Catch::Matchers::Equals("restored"));
+    }
@@ -0,0 +1,98 @@
+#include "memprop/registry.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include <string>
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    class registered_widget {
+    public:
+        public_property<registered_widget, float> Opacity {this, 1.0f};
+        public_property<registered_widget, int> Width {this, 10};
+        readonly_property<registered_widget, std::string> Name {this, "widget"};
+
+        using properties = property_list<registered_widget,
+                                         property_entry<"Opacity", &registered_widget::Opacity>,
+                                         property_entry<"Width", &registered_widget::Width>,
+                                         property_entry<"Name", &registered_widget::Name>>;
+    };
+
+
+    class external_widget {
+    public:
+        public_property<external_widget, int> Height {this};
+    };
+    }
+
+
+template <>
+struct mousebyte::memprop::property_registry<external_widget> {
+    using type = property_list<external_widget,
+                               property_entry<"Height", &external_widget::Height>>;
+};
+
+
+TEST_CASE("Registered properties can be enumerated") {
+    registered_widget        w;
+    std::vector<std::string> names;
+
+    for_each_property(w, [&](std::string_view name, auto&)
+        {
+        names.emplace_back(name);
+        });
+    REQUIRE(names == std::vector<std::string> {"Opacity", "Width", "Name"});
+    REQUIRE(get_property<1>(w) == 10);
+    get_property<1>(w) = 12;
+    REQUIRE(w.Width == 12);
+    }
+
+TEST_CASE("Registered properties can be found by name") {
+    registered_widget w;
+    using props = properties_of<registered_widget>;
+
+    static_assert(props::index_of("Width") == 1);
+    static_assert(props::index_of("Height") == props::npos);
+    REQUIRE(props::index_of(std::string("Name")) == 2);
+
+    float opacity = 0;
+    auto  found   = visit_property(w, "Opacity", [&](auto& p)
+        {
+        if constexpr (requires { static_cast<float>(p); }) opacity = p;
+        });
+    REQUIRE(found);
+    REQUIRE(opacity == 1.0f);
+    REQUIRE_FALSE(visit_property(w, "Opacit", [](auto&) { }));
+
+    external_widget e;
+    REQUIRE(visit_property(e, "Height", [](auto& p) { p = 3; }));
+    REQUIRE(e.Height == 3);
+    }
+
+namespace {
+    template <std::size_t ... I>
+    constexpr bool all_names_found(
+        std::index_sequence<I...>
+        )
+        {
+        constexpr std::array<std::string_view, 40> names {
+            "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n",
+            "o", "p", "q", "r", "s", "t", "Visible", "Enabled", "Focused", "Hovered",
+            "Width", "Height", "X", "Y", "Opacity", "Scale", "Rotation", "Text",
+            "Font", "Color", "Background", "Border", "Margin", "Padding", "Tag", "Id"
+            };
+        constexpr detail::perfect_hash<40> hash {names};
+        return ((hash.find(names[I], names) == I) && ...)
+               && hash.find("Missing", names) == hash.npos;
+        }
+    }
+
+
+TEST_CASE("Perfect hashes are generated at compile time") {
+    static_assert(all_names_found(std::make_index_sequence<40>{}));
+
+    // duplicate names are rejected instead of searched for forever
+    constexpr std::array<std::string_view, 3> duplicates {"Width", "Height", "Width"};
+    constexpr detail::perfect_hash<3>          hash {duplicates};
+    static_assert(!hash.complete);
+    }
@@ -0,0 +1,142 @@
+#include "memprop/coro.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include <string>
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    class row
+        : public relocatable {
+        bool set_limited(
+            int&       o,
+            int const& v
+            )
+            {
+            if (v > Limit) return false;
+            o = v;
+            return true;
+            }
+
+        int doubled() const
+            {
+            return Value * 2;
+            }
+
+    public:
+        int Limit = 100;
+
+        public_property<row, int> Value {this, 0};
+        public_property<row, int, &row::set_limited> Limited {this, 0};
+        readonly_property<row, std::string> Label {this};
+        computed_property<row, int, &row::doubled> Doubled {this};
+        public_property<row, int, nullptr, single_threaded> Local {this, 0};
+
+        explicit row(
+            std::string label
+            )
+            {
+            Label = std::move(label);
+            }
+    };
+
+
+    class panel {
+    public:
+        public_property<panel, int> Value {this, 0};
+    };
+
+
+    task collect(
+        row&              r,
+        std::vector<int>& out
+        )
+        {
+        auto stream = r.Value.changes();
+
+        while (out.size() < 2) out.push_back(co_await stream.next());
+        }
+    }
+
+
+TEST_CASE("Owners of relocatable properties can be stored by value") {
+    std::vector<row> rows;
+    auto             changes = 0;
+    auto             local   = 0;
+
+    rows.reserve(1);
+    rows.emplace_back("first");
+    auto c = rows[0].Value.Changed.connect([&](int const&)
+        {
+        ++changes;
+        });
+    rows[0].Local.Changed.connect([&](int const&)
+        {
+        ++local;
+        });
+
+    for (auto i = 0; i < 100; ++i) rows.emplace_back(std::to_string(i));
+
+    rows[0].Value = 21;
+    rows[0].Local = 1;
+    REQUIRE(changes == 1);
+    REQUIRE(local == 1);
+    REQUIRE(c.connected());
+    REQUIRE(rows[0].Doubled == 42);
+    REQUIRE_THAT(rows[0].Label, Catch::Matchers::Equals("first"));
+
+    rows[0].Limit = 5;
+    rows[0].Limited = 10;
+    REQUIRE(rows[0].Limited == 0);
+    rows[0].Limited = 4;
+    REQUIRE(rows[0].Limited == 4);
+    }
+
+TEST_CASE("Bindings follow relocated properties") {
+    std::vector<row> rows;
+    panel            p;
+
+    rows.reserve(2);
+    rows.emplace_back("source");
+    rows.emplace_back("target");
+    rows[1].Value.bind(rows[0].Value);
+    auto twoWay = bind_two_way(p.Value, rows[0].Limited);
+
+    for (auto i = 0; i < 100; ++i) rows.emplace_back(std::to_string(i));
+
+    rows[0].Value = 8;
+    REQUIRE(rows[1].Value == 8);
+    p.Value = 3;
+    REQUIRE(rows[0].Limited == 3);
+    rows[0].Limited = 9;
+    REQUIRE(p.Value == 9);
+
+    SECTION("Properties assigned to drop their bindings") {
+        rows.erase(rows.begin());
+        REQUIRE_THAT(rows[0].Label, Catch::Matchers::Equals("target"));
+        REQUIRE(rows[0].Value == 8);
+        p.Value = 4;
+        REQUIRE(rows[0].Limited == 0);
+        }
+    SECTION("Target properties keep their bindings when moved") {
+        std::swap(rows[0], rows[2]);
+        rows[2].Value = 5;
+        REQUIRE(rows[1].Value == 5);
+        }
+    }
+
+TEST_CASE("Change streams follow relocated properties") {
+    std::vector<row> rows;
+    std::vector<int> seen;
+
+    rows.reserve(1);
+    rows.emplace_back("streamed");
+    auto t = collect(rows[0], seen);
+
+    for (auto i = 0; i < 100; ++i) rows.emplace_back(std::to_string(i));
+
+    rows[0].Value = 1;
+    rows[0].Value = 2;
+    REQUIRE(t.done());
+    REQUIRE(seen == std::vector<int> {1, 2});
+    }
@@ -0,0 +1,163 @@
+#include "memprop/shared.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+using namespace mousebyte::memprop;
+
+namespace {
+    struct engine_state {
+        int frame;
+        double load;
+    };
+
+
+    std::string segment_name(
+        char const* name
+        )
+        {
+        return "/memprop_" + std::string(name) + "_" + std::to_string(::getpid());
+        }
+
+
+    class engine {
+    public:
+        public_property<engine, int> Frame {this, 0};
+        public_property<engine, double> Load {this, 0.0};
+    };
+
+
+    class engine_view {
+    public:
+        shared_subscriber<engine_state> Source;
+        shared_property<engine_view, &engine_state::frame> Frame {this, Source};
+        shared_property<engine_view, &engine_state::load> Load {this, Source};
+
+        explicit engine_view(
+            std::string const& name,
+            std::uint32_t      schema = 1
+            )
+            : Source(name, schema)
+            {
+            }
+    };
+    }
+
+
+TEST_CASE("Shared properties follow their published properties") {
+    auto                           name = segment_name("follow");
+    engine                         e;
+    shared_publisher<engine_state> publisher(name, 1);
+
+    REQUIRE(publisher.valid());
+    e.Frame = 3;
+    publisher.publish<&engine_state::frame>(e.Frame);
+    publisher.publish<&engine_state::load>(e.Load);
+
+    engine_view view(name);
+    auto        frames = 0;
+    auto        loads  = 0;
+
+    REQUIRE(view.Source.status() == shared_status::connected);
+    view.Frame.Changed.connect([&](int const&)
+        {
+        ++frames;
+        });
+    view.Load.Changed.connect([&](double const&)
+        {
+        ++loads;
+        });
+
+    REQUIRE(view.Source.poll());
+    REQUIRE(view.Frame == 3);
+    REQUIRE(frames == 1);
+    REQUIRE(loads == 0);
+    REQUIRE_FALSE(view.Source.poll());
+
+    SECTION("Changes between polls are coalesced") {
+        e.Frame = 4;
+        e.Frame = 5;
+        e.Load  = 0.5;
+        REQUIRE(view.Source.poll());
+        REQUIRE(view.Frame == 5);
+        REQUIRE(view.Load == 0.5);
+        REQUIRE(frames == 2);
+        REQUIRE(loads == 1);
+        }
+    SECTION("Batches ring the doorbell once they close") {
+        {
+        shared_publisher<engine_state>::batch batch(publisher);
+        e.Frame = 6;
+        e.Load  = 0.25;
+        REQUIRE_FALSE(view.Source.poll());
+        }
+        REQUIRE(view.Source.poll());
+        REQUIRE(view.Frame == 6);
+        REQUIRE(view.Load == 0.25);
+        }
+    SECTION("Waiting returns once a value is published") {
+        REQUIRE_FALSE(view.Source.wait(std::chrono::milliseconds(1)));
+        e.Frame = 7;
+        REQUIRE(view.Source.wait(std::chrono::seconds(5)));
+        REQUIRE(view.Frame == 7);
+        }
+    }
+
+TEST_CASE("Shared subscribers report the state of their segment") {
+    auto name = segment_name("status");
+
+    SECTION("Missing segments") {
+        engine_view view(name);
+        REQUIRE(view.Source.status() == shared_status::not_found);
+        REQUIRE_FALSE(view.Source.poll());
+
+        shared_publisher<engine_state> publisher(name, 1, {9, 0.0});
+        REQUIRE(view.Source.open() == shared_status::connected);
+        REQUIRE(view.Source.poll());
+        REQUIRE(view.Frame == 9);
+        }
+    SECTION("Other layouts") {
+        shared_publisher<engine_state> publisher(name, 1);
+        engine_view                    view(name, 2);
+        REQUIRE(view.Source.status() == shared_status::schema_mismatch);
+        }
+    SECTION("Closed publishers") {
+        auto publisher = std::make_unique<shared_publisher<engine_state>>(name, 1);
+        engine_view view(name);
+        REQUIRE(view.Source.status() == shared_status::connected);
+        publisher.reset();
+        REQUIRE(view.Source.status() == shared_status::closed);
+        REQUIRE(view.Source.open() == shared_status::not_found);
+        }
+    }
+
+TEST_CASE("Shared subscribers give up on writes that never finish") {
+    auto                           name = segment_name("stalled");
+    engine                         e;
+    shared_publisher<engine_state> publisher(name, 1);
+    engine_view                    view(name);
+
+    publisher.publish<&engine_state::frame>(e.Frame);
+    REQUIRE_FALSE(view.Source.poll());
+
+    // stands in for a publisher that died part way through a write
+    int  fd     = ::shm_open(name.c_str(), O_RDWR, 0);
+    auto map    = ::mmap(nullptr, sizeof(detail::shared_header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    auto header = static_cast<detail::shared_header*>(map);
+
+    ::close(fd);
+    REQUIRE(map != MAP_FAILED);
+    header->sequence.fetch_add(1);
+    header->doorbell.fetch_add(1);
+    REQUIRE_FALSE(view.Source.poll());
+    REQUIRE(view.Source.status() == shared_status::stalled);
+
+    header->sequence.fetch_add(1);
+    e.Frame = 4;
+    REQUIRE(view.Source.poll());
+    REQUIRE(view.Source.status() == shared_status::connected);
+    REQUIRE(view.Frame == 4);
+    ::munmap(map, sizeof(detail::shared_header));
+    }
@@ -0,0 +1,170 @@
+#include "memprop/snapshot.hpp"
+#include "memprop/interned.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include <memory>
+using namespace mousebyte::memprop;
+
+namespace {
+    struct point {
+        int x, y;
+    };
+
+
+    class snapshot_widget {
+        bool set_width(
+            int&       o,
+            int const& v
+            )
+            {
+            if (v < 0) return false;
+            o = v;
+            return true;
+            }
+
+        int area() const
+            {
+            return Width * 2;
+            }
+
+    public:
+        public_property<snapshot_widget, int, &snapshot_widget::set_width> Width {this};
+        public_property<snapshot_widget, point> Position {this};
+        readonly_property<snapshot_widget, std::string> Name {this};
+        computed_property<snapshot_widget, int, &snapshot_widget::area> Area {this};
+
+        void set_name(
+            std::string const& n
+            )
+            {
+            Name = n;
+            }
+
+        using properties = property_list<snapshot_widget,
+                                         property_entry<"Width", &snapshot_widget::Width>,
+                                         property_entry<"Position", &snapshot_widget::Position>,
+                                         property_entry<"Name", &snapshot_widget::Name>,
+                                         property_entry<"Area", &snapshot_widget::Area>>;
+    };
+
+
+    class fixed_widget {
+    public:
+        public_property<fixed_widget, float> Opacity {this};
+        public_property<fixed_widget, int> Width {this};
+
+        using properties = property_list<fixed_widget,
+                                         property_entry<"Opacity", &fixed_widget::Opacity>,
+                                         property_entry<"Width", &fixed_widget::Width>>;
+    };
+
+
+    class other_widget {
+    public:
+        public_property<other_widget, float> Opacity {this};
+        public_property<other_widget, double> Width {this};
+
+        using properties = property_list<other_widget,
+                                         property_entry<"Opacity", &other_widget::Opacity>,
+                                         property_entry<"Width", &other_widget::Width>>;
+    };
+    }
+
+
+TEST_CASE("Owners can be saved and restored") {
+    snapshot_widget src;
+
+    src.Width    = 12;
+    src.Position = point {3, 4};
+    src.set_name("saved");
+    std::vector<std::byte> data;
+    save_snapshot(src, data);
+
+    snapshot_widget dst;
+    auto            changes = 0;
+    auto            width   = 0;
+
+    dst.Width.Changed.connect([&](int const&)
+        {
+        ++changes;
+        });
+    dst.Name.Changed.connect([&](std::string const&)
+        {
+        // with coalesced notifications, every value is already restored
+        width = dst.Width;
+        ++changes;
+        });
+
+    SECTION("Coalesced notifications are emitted after all values are restored") {
+        REQUIRE(restore_snapshot(dst, data) == snapshot_status::ok);
+        REQUIRE(dst.Width == 12);
+        REQUIRE(static_cast<point const&>(dst.Position).y == 4);
+        REQUIRE_THAT(dst.Name, Catch::Matchers::Equals("saved"));
+        REQUIRE(changes == 2);
+        REQUIRE(width == 12);
+        }
+    SECTION("Notifications can be suppressed") {
+        REQUIRE(restore_snapshot(dst, data, restore_notify::none) == snapshot_status::ok);
+        REQUIRE(dst.Width == 12);
+        REQUIRE(changes == 0);
+        }
+    SECTION("Notifications can be emitted as each value is restored") {
+        REQUIRE(restore_snapshot(dst, data, restore_notify::each) == snapshot_status::ok);
+        REQUIRE(changes == 2);
+        REQUIRE(width == 12);
+        }
+    SECTION("Corrupt data is rejected") {
+        auto truncated = std::span<std::byte const>(data).first(data.size() - 2);
+        REQUIRE(restore_snapshot(dst, truncated) == snapshot_status::truncated);
+        REQUIRE(restore_snapshot(dst, std::span<std::byte const>(data).subspan(1))
+                == snapshot_status::bad_magic);
+        }
+    }
+
+TEST_CASE("Snapshots check the schema and owner count") {
+    std::vector<std::unique_ptr<fixed_widget>> widgets;
+
+    for (auto i = 0; i < 3; ++i) {
+        widgets.push_back(std::make_unique<fixed_widget>());
+        widgets.back()->Width = i;
+        }
+    std::vector<std::byte> data;
+    save_snapshot(widgets, data);
+
+    std::vector<std::unique_ptr<fixed_widget>> restored;
+
+    for (auto i = 0; i < 3; ++i) {
+        restored.push_back(std::make_unique<fixed_widget>());
+        }
+    REQUIRE(restore_snapshot(restored, data) == snapshot_status::ok);
+    REQUIRE(restored[2]->Width == 2);
+    restored.pop_back();
+    REQUIRE(restore_snapshot(restored, data) == snapshot_status::count_mismatch);
+    other_widget other;
+    std::vector<std::byte> one;
+    save_snapshot(*widgets[0], one);
+    REQUIRE(restore_snapshot(other, one) == snapshot_status::schema_mismatch);
+
+    // the schema hash only depends on names and value formats
+    static_assert(detail::value_schema_hash<std::int32_t>() == detail::name_hash("int", 4));
+    static_assert(detail::value_schema_hash<std::string>()
+                  == detail::value_schema_hash<interned_string>());
+    }
+
+TEST_CASE("Truncated block copied snapshots leave owners unchanged") {
+    std::vector<std::unique_ptr<fixed_widget>> widgets;
+    std::vector<std::unique_ptr<fixed_widget>> restored;
+
+    for (auto i = 0; i < 3; ++i) {
+        widgets.push_back(std::make_unique<fixed_widget>());
+        widgets.back()->Width = i + 1;
+        restored.push_back(std::make_unique<fixed_widget>());
+        restored.back()->Width = 0;
+        }
+    std::vector<std::byte> data;
+    save_snapshot(widgets, data);
+
+    auto truncated = std::span<std::byte const>(data).first(data.size() - 1);
+    REQUIRE(restore_snapshot(restored, truncated) == snapshot_status::truncated);
+    for (auto& w : restored) REQUIRE(w->Width == 0);
+    }
@@ -0,0 +1,156 @@
+#include "memprop/sparse.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_string.hpp"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    std::string const& default_font()
+        {
+        static std::string const font = "Sans";
+        return font;
+        }
+
+
+    class sparse_widget
+        : public sparse_storage {
+    public:
+        sparse_public_property<sparse_widget, int> Margin {this};
+        sparse_public_property<sparse_widget, std::string, &default_font> Font {this};
+        sparse_readonly_property<sparse_widget, float> Scale {this};
+
+        void set_scale(
+            float s
+            )
+            {
+            Scale = s;
+            }
+
+        void clear_scale()
+            {
+            Scale.clear();
+            }
+    };
+
+
+    class tracked_sparse_widget
+        : public sparse_storage,
+          public dirty_tracking<> {
+    public:
+        public_property<tracked_sparse_widget, int> Width {this, 0};
+        sparse_public_property<tracked_sparse_widget, float> Opacity {this};
+        sparse_public_property<tracked_sparse_widget, bool> Visible {this};
+    };
+    }
+
+
+TEST_CASE("Sparse properties resolve to a shared default") {
+    sparse_widget w1;
+    sparse_widget w2;
+
+    REQUIRE(w1.Margin == 0);
+    REQUIRE_THAT(w1.Font, Catch::Matchers::Equals("Sans"));
+    REQUIRE(&static_cast<std::string const&>(w1.Font)
+            == &static_cast<std::string const&>(w2.Font));
+    REQUIRE(w1.stored_count() == 0);
+    REQUIRE_FALSE(w1.Font.is_set());
+    }
+
+TEST_CASE("Only explicitly set sparse values are stored") {
+    sparse_widget w1;
+    sparse_widget w2;
+    std::string   changed;
+
+    w1.Font.property().Changed.connect([&](std::string const& v)
+        {
+        changed = v;
+        });
+    w1.Font = "Mono";
+    REQUIRE_THAT(w1.Font, Catch::Matchers::Equals("Mono"));
+    REQUIRE_THAT(changed, Catch::Matchers::Equals("Mono"));
+    REQUIRE_THAT(w2.Font, Catch::Matchers::Equals("Sans"));
+    REQUIRE(w1.Font.is_set());
+    REQUIRE(w1.stored_count() == 1);
+
+    w1.set_scale(2.0f);
+    w1.Margin = 4;
+    REQUIRE(w1.Scale == 2.0f);
+    REQUIRE(w1.Margin == 4);
+    REQUIRE(w1.stored_count() == 3);
+
+    w1.Font.clear();
+    REQUIRE_THAT(w1.Font, Catch::Matchers::Equals("Sans"));
+    REQUIRE_THAT(changed, Catch::Matchers::Equals("Sans"));
+    REQUIRE_FALSE(w1.Font.is_set());
+    w1.clear_scale();
+    REQUIRE(w1.Scale == 0.0f);
+    REQUIRE(w1.stored_count() == 1);
+    }
+
+TEST_CASE("Sparse properties can be bound") {
+    sparse_widget w1;
+    sparse_widget w2;
+
+    w2.Margin.bind(w1.Margin.property());
+    REQUIRE(w2.Margin.is_set());
+    w1.Margin = 8;
+    REQUIRE(w2.Margin == 8);
+    w2.Margin.unbind();
+    w1.Margin = 9;
+    REQUIRE(w2.Margin == 8);
+    }
+
+TEST_CASE("Unset sparse properties take only a handle") {
+    sparse_widget w;
+
+    REQUIRE(sizeof(w.Margin) <= sizeof(void*));
+    REQUIRE(sizeof(w.Margin) * 8 < sizeof(public_property<sparse_widget, int>));
+
+    // observing a property creates its cell, but does not set it
+    auto changes = 0;
+
+    w.Margin.property().Changed.connect([&](int const&)
+        {
+        ++changes;
+        });
+    REQUIRE_FALSE(w.Margin.is_set());
+    REQUIRE(w.stored_count() == 0);
+    w.Margin = 3;
+    REQUIRE(changes == 1);
+    REQUIRE(w.stored_count() == 1);
+    }
+
+TEST_CASE("Sparse properties keep their ids in construction order") {
+    tracked_sparse_widget w;
+
+    REQUIRE(w.property_count() == 3);
+    REQUIRE(w.Opacity.id() == 1);
+    w.Opacity = 0.5f;
+    REQUIRE(w.is_dirty(w.Opacity.id()));
+    REQUIRE_FALSE(w.is_dirty(w.Visible.id()));
+    }
+
+TEST_CASE("Sparse properties of one owner can be first set and read on different threads") {
+    std::vector<std::unique_ptr<sparse_widget>> widgets;
+
+    for (auto i = 0; i < 200; ++i) {
+        widgets.push_back(std::make_unique<sparse_widget>());
+        widgets.back()->Margin = i;
+        }
+    std::thread setter([&]
+        {
+        for (auto& w : widgets) {
+            w->Font = "Mono";
+            w->set_scale(2.0f);
+            }
+        });
+    auto sum = 0;
+
+    for (auto& w : widgets) sum += w->Margin;
+    setter.join();
+    REQUIRE(sum == 199 * 200 / 2);
+    REQUIRE(widgets.back()->stored_count() == 3);
+    }
@@ -0,0 +1,90 @@
+#include "memprop/static_binding.hpp"
+#include "catch2/catch_test_macros.hpp"
+using namespace mousebyte::memprop;
+
+namespace {
+    class frame {
+        int scaled(
+            int const&    h,
+            double const& ratio
+            ) const
+            {
+            return static_cast<int>(h * ratio) + Border;
+            }
+
+    public:
+        int Border = 0;
+
+        public_property<frame, int> Height {this, 10};
+        public_property<frame, double> AspectRatio {this, 2.0};
+        public_property<frame, int> Width {this, 0};
+        readonly_property<frame, int> Area {this, 0};
+        public_property<frame, int> MinWidth {this, 0};
+
+        using static_bindings = static_binding_list<
+            static_binding<&frame::Width, &frame::scaled, &frame::Height, &frame::AspectRatio>,
+            static_binding<&frame::Area, [](int const& w, int const& h)
+                {
+                return w * h;
+                }, &frame::Width, &frame::Height>,
+            static_binding<&frame::MinWidth, nullptr, &frame::Width>>;
+
+        frame()
+            {
+            sync_static_bindings(*this);
+            }
+    };
+
+
+    class slider {
+    public:
+        public_property<slider, int> Value {this, 0};
+    };
+    }
+
+
+TEST_CASE("Static bindings propagate changes within an owner") {
+    frame f;
+    auto  widthChanges = 0;
+
+    REQUIRE(f.Width == 20);
+    REQUIRE(f.Area == 200);
+    REQUIRE(f.MinWidth == 20);
+
+    f.Width.Changed.connect([&](int const&)
+        {
+        ++widthChanges;
+        });
+    f.Height = 5;
+    REQUIRE(f.Width == 10);
+    REQUIRE(f.Area == 50);
+    REQUIRE(f.MinWidth == 10);
+    REQUIRE(widthChanges == 1);
+
+    f.Border      = 1;
+    f.AspectRatio = 3.0;
+    REQUIRE(f.Width == 16);
+    REQUIRE(f.Area == 80);
+
+    // the targets remain ordinary properties
+    f.Width = 7;
+    REQUIRE(f.Area == 35);
+    REQUIRE(f.MinWidth == 7);
+    }
+
+TEST_CASE("Static bindings coexist with runtime bindings") {
+    frame  f;
+    slider s;
+
+    auto binding = f.Height.bind(s.Value);
+    REQUIRE(f.Width == 0);
+    s.Value = 4;
+    REQUIRE(f.Height == 4);
+    REQUIRE(f.Width == 8);
+    REQUIRE(f.Area == 32);
+
+    slider mirror;
+    mirror.Value.bind(f.Area);
+    s.Value = 6;
+    REQUIRE(mirror.Value == 72);
+    }
@@ -0,0 +1,100 @@
+#include "memprop/table.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <memory>
+using namespace mousebyte::memprop;
+
+class table_widget {
+public:
+    static inline property_table<table_widget, float> opacity_table;
+    table_property<table_widget, float> Opacity {this, opacity_table, 1.0f};
+};
+
+
+TEST_CASE("Table properties store their values contiguously") {
+    std::vector<std::unique_ptr<table_widget>> widgets;
+
+    for (auto i = 0; i < 4; ++i) {
+        widgets.push_back(std::make_unique<table_widget>());
+        }
+    auto& table = table_widget::opacity_table;
+
+    REQUIRE(table.size() == 4);
+
+    SECTION("Table properties can be get and set through the handle") {
+        widgets[2]->Opacity = 0.5f;
+        REQUIRE(widgets[2]->Opacity == 0.5f);
+        REQUIRE(table.values()[2] == 0.5f);
+        }
+    SECTION("Bulk updates emit Changed once per property") {
+        auto changes = 0;
+
+        for (auto& w : widgets) {
+            w->Opacity.Changed.connect([&](float const&)
+                {
+                ++changes;
+                });
+            }
+        table.update([](std::span<float> values)
+            {
+            for (auto& v : values) v *= 0.5f;
+            });
+        REQUIRE(changes == 4);
+        REQUIRE(widgets[3]->Opacity == 0.5f);
+        float const in[] = {0.1f, 0.2f};
+        table.set_all(in);
+        REQUIRE(changes == 6);
+        REQUIRE(widgets[1]->Opacity == 0.2f);
+        REQUIRE(widgets[2]->Opacity == 0.5f);
+        std::vector<float> out(table.size());
+        table.get_all(out);
+        REQUIRE(out[0] == 0.1f);
+        }
+    SECTION("Destroying a handle keeps the table dense") {
+        widgets[3]->Opacity = 0.25f;
+        widgets.erase(widgets.begin() + 1);
+        REQUIRE(table.size() == 3);
+        REQUIRE(widgets[2]->Opacity.index() == 1);
+        REQUIRE(widgets[2]->Opacity == 0.25f);
+        REQUIRE(&table.handle(1) == &widgets[2]->Opacity);
+        }
+    }
+
+TEST_CASE("Table property slots can create and destroy handles") {
+    auto& table = table_widget::opacity_table;
+    std::vector<std::unique_ptr<table_widget>> others;
+    std::vector<float>                         seen;
+
+    others.push_back(std::make_unique<table_widget>());
+    auto w = std::make_unique<table_widget>();
+
+    SECTION("Creating handles") {
+        w->Opacity.Changed.connect([&](float const&)
+            {
+            // enough handles to reallocate the table's values
+            for (auto i = 0; i < 64; ++i) others.push_back(std::make_unique<table_widget>());
+            });
+        w->Opacity.Changed.connect([&](float const& v)
+            {
+            seen.push_back(v);
+            });
+        w->Opacity = 0.25f;
+        REQUIRE(table.size() == 66);
+        }
+    SECTION("Destroying handles") {
+        w->Opacity.Changed.connect([&](float const&)
+            {
+            // moves w into the first slot, and puts a new value where w was
+            others.front().reset();
+            others.push_back(std::make_unique<table_widget>());
+            });
+        w->Opacity.Changed.connect([&](float const& v)
+            {
+            seen.push_back(v);
+            });
+        w->Opacity = 0.25f;
+        REQUIRE(w->Opacity.index() == 0);
+        REQUIRE(table.size() == 2);
+        }
+    REQUIRE(seen == std::vector<float> {0.25f});
+    REQUIRE(w->Opacity == 0.25f);
+    }
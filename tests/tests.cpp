@@ -309,3 +309,148 @@ TEST_CASE("Properties can be bound") {
         REQUIRE(t2.IntProp1 == 72);
         }
     }
+
+TEST_CASE("Properties can be bound two-way") {
+    test_class  t1;
+    test_class2 t2;
+
+    SECTION("Setting either property updates the other") {
+        t1.IntProp1  = 5;
+        auto binding = bind_two_way(t2.IntProp1, t1.IntProp1);
+        REQUIRE(t2.IntProp1 == 5);
+        t2.IntProp1  = 37;
+        REQUIRE(t1.IntProp1 == 37);
+        t1.IntProp1  = 608;
+        REQUIRE(t2.IntProp1 == 608);
+        binding->disconnect();
+        REQUIRE_FALSE(binding->active());
+        t1.IntProp1  = 12;
+        REQUIRE(t2.IntProp1 == 608);
+        }
+    SECTION("The initial sync direction can be chosen") {
+        t1.IntProp1  = 5;
+        t2.IntProp1  = 9;
+        auto binding = bind_two_way(t2.IntProp1, t1.IntProp1, sync_direction::to_second);
+        REQUIRE(t1.IntProp1 == 9);
+        t1.IntProp2  = 3;
+        auto other   = bind_two_way(t1.IntProp2, t2.IntProp1, sync_direction::none);
+        REQUIRE(t1.IntProp2 == 3);
+        REQUIRE(t2.IntProp1 == 9);
+        }
+    SECTION("Two-way bindings do not occupy the binding slot") {
+        auto binding = bind_two_way(t2.IntProp1, t1.IntProp1);
+        t1.IntProp1.bind(t1.IntProp2);
+        t1.IntProp2  = 4;
+        REQUIRE(t1.IntProp1 == 4);
+        REQUIRE(t2.IntProp1 == 4);
+        }
+    SECTION("Two-way bindings can use a pair of converters") {
+        t2.IntProp1  = 3;
+        auto binding = bind_two_way(t2.StringProp1, t2.IntProp1,
+                                    [](std::string const& s) { return static_cast<int>(s.size()); },
+                                    [](int const& i) { return std::string(i, 'x'); });
+        REQUIRE_THAT(t2.StringProp1, Catch::Matchers::Equals("xxx"));
+        t2.StringProp1 = "hello";
+        REQUIRE(t2.IntProp1 == 5);
+        t2.IntProp1    = 2;
+        REQUIRE_THAT(t2.StringProp1, Catch::Matchers::Equals("xx"));
+        }
+    }
+
+class dirty_test_class
+    : public dirty_tracking<> {
+    bool set_limited(
+        int&       o,
+        int const& i
+        )
+        {
+        if (i > 100) return false;
+        o = i;
+        return true;
+        }
+
+    int compute() const
+        {
+        return 1;
+        }
+
+public:
+    public_property<dirty_test_class, int> IntProp1 {this};
+    public_property<dirty_test_class, int, &dirty_test_class::set_limited> IntProp2 {this};
+    readonly_property<dirty_test_class, std::string> StringProp {this};
+    computed_property<dirty_test_class, int, &dirty_test_class::compute> ComputedProp {this};
+    public_property<dirty_test_class, float> FloatProp {this};
+
+    void set_string(
+        std::string const& s
+        )
+        {
+        StringProp = s;
+        }
+};
+
+
+TEST_CASE("Owners can track dirty properties") {
+    dirty_test_class t;
+
+    REQUIRE(t.property_count() == 4);
+    REQUIRE(t.IntProp1.id() == 0);
+    REQUIRE(t.FloatProp.id() == 3);
+    REQUIRE_FALSE(t.is_dirty());
+
+    t.IntProp2  = 500;
+    REQUIRE_FALSE(t.is_dirty());
+    t.FloatProp = 2.0f;
+    t.set_string("dirty");
+    t.IntProp1  = 4;
+    REQUIRE(t.is_dirty(t.StringProp.id()));
+
+    std::vector<property_id> ids;
+    t.consume_dirty([&](property_id id)
+        {
+        ids.push_back(id);
+        });
+    REQUIRE(ids == std::vector<property_id> {0, 2, 3});
+    REQUIRE_FALSE(t.is_dirty());
+    t.IntProp2  = 5;
+    REQUIRE(t.is_dirty(t.IntProp2.id()));
+    t.clear_dirty();
+    REQUIRE_FALSE(t.is_dirty());
+    }
+
+class reporting_test_class
+    : public dirty_tracking<>,
+      public change_reporting<single_threaded> {
+public:
+    public_property<reporting_test_class, int> IntProp {this, 0};
+    readonly_property<reporting_test_class, std::string> StringProp {this};
+
+    void set_string(
+        std::string const& s
+        )
+        {
+        StringProp = s;
+        }
+};
+
+TEST_CASE("Owners can report changes of any property") {
+    reporting_test_class     t;
+    std::vector<property_id> ids;
+    std::string              text;
+    auto                     sum = 0;
+
+    t.PropertyChanged.connect([&](property_id id, changed_value v)
+        {
+        ids.push_back(id);
+        if (auto i = v.get_if<int>()) sum += *i;
+        if (auto s = v.get_if<std::string>()) text = *s;
+        REQUIRE_FALSE(v.get_if<float>());
+        });
+    t.IntProp = 3;
+    t.set_string("reported");
+    t.IntProp = 4;
+    REQUIRE(ids == std::vector<property_id> {0, 1, 0});
+    REQUIRE(sum == 7);
+    REQUIRE(text == "reported");
+    REQUIRE(t.is_dirty(t.StringProp.id()));
+    }
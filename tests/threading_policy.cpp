@@ -0,0 +1,164 @@
+#include "memprop/memprop.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <memory>
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    class widget {
+        bool set_clamped(
+            int&       value,
+            int const& v
+            )
+            {
+            value = v < 0 ? 0 : v;
+            return true;
+            }
+
+    public:
+        public_property<widget, int, nullptr, single_threaded> Width {this, 0};
+        public_property<widget, int, &widget::set_clamped, single_threaded> Height {this, 0};
+        public_property<widget, int> SharedWidth {this, 0};
+        readonly_property<widget, int, nullptr, single_threaded> Area {this, 0};
+
+        void update_area()
+            {
+            int width  = Width;
+            int height = Height;
+
+            Area = width * height;
+            }
+    };
+    }
+
+static_assert(std::same_as<decltype(widget::Width)::value_type, int>);
+static_assert(std::same_as<detail::traits::policy_type<decltype(widget::Width)>, single_threaded>);
+static_assert(std::same_as<detail::traits::policy_type<decltype(widget::SharedWidth)>, thread_safe>);
+
+TEST_CASE("Single-threaded properties notify through an unsynchronized signal") {
+    widget           w;
+    std::vector<int> seen;
+
+    SECTION("Slots are called in order of connection") {
+        auto first = w.Width.Changed.connect([&](int const& v)
+            {
+            seen.push_back(v);
+            });
+        w.Width.Changed.connect([&](int const& v)
+            {
+            seen.push_back(-v);
+            });
+        REQUIRE(w.Width.Changed.slot_count() == 2);
+        w.Width = 3;
+        REQUIRE(seen == std::vector<int> {3, -3});
+
+        REQUIRE(first.disconnect());
+        REQUIRE_FALSE(first.connected());
+        REQUIRE_FALSE(first.disconnect());
+        w.Width = 4;
+        REQUIRE(seen == std::vector<int> {3, -3, -4});
+        REQUIRE(w.Width.Changed.slot_count() == 1);
+        }
+    SECTION("Setters and readonly properties use the policy too") {
+        w.Height.Changed.connect([&](int const& v)
+            {
+            seen.push_back(v);
+            });
+        w.Area.Changed.connect([&](int const& v)
+            {
+            seen.push_back(v);
+            });
+        w.Width  = 2;
+        w.Height = -5;
+        w.Height = 5;
+        w.update_area();
+        REQUIRE(seen == std::vector<int> {0, 5, 10});
+        }
+    SECTION("Blocked slots are skipped") {
+        auto c = w.Width.Changed.connect([&](int const& v)
+            {
+            seen.push_back(v);
+            });
+        c.block();
+        w.Width = 1;
+        c.unblock();
+        w.Width = 2;
+        REQUIRE(seen == std::vector<int> {2});
+        }
+    SECTION("Scoped connections disconnect when destroyed") {
+        {
+        unsynchronized_scoped_connection c = w.Width.Changed.connect([&](int const& v)
+            {
+            seen.push_back(v);
+            });
+        w.Width = 1;
+        }
+        w.Width = 2;
+        REQUIRE(seen == std::vector<int> {1});
+        }
+    SECTION("Connections outlive the property") {
+        unsynchronized_connection c;
+        {
+        widget temp;
+        c = temp.Width.Changed.connect([](int const&) {});
+        REQUIRE(c.connected());
+        }
+        REQUIRE(c.valid());
+        REQUIRE_FALSE(c.connected());
+        }
+    }
+
+TEST_CASE("Unsynchronized slots can connect and disconnect during emission") {
+    widget                    w;
+    std::vector<int>          seen;
+    unsynchronized_connection self;
+    unsynchronized_connection later;
+
+    self = w.Width.Changed.connect([&](int const& v)
+        {
+        seen.push_back(v);
+        self.disconnect();
+        later = w.Width.Changed.connect([&](int const& v)
+            {
+            seen.push_back(v * 10);
+            });
+        });
+    w.Width.Changed.connect([&](int const& v)
+        {
+        seen.push_back(-v);
+        if (v == 1) w.Width = 2;
+        });
+
+    w.Width = 1;
+    REQUIRE(seen == std::vector<int> {1, -1, -2, 20});
+    REQUIRE(w.Width.Changed.slot_count() == 2);
+    }
+
+TEST_CASE("Properties of different policies can be bound") {
+    widget w;
+
+    SECTION("One-way") {
+        w.SharedWidth.bind(w.Width);
+        w.Width = 7;
+        REQUIRE(w.SharedWidth == 7);
+        }
+    SECTION("Two-way") {
+        auto binding = bind_two_way(w.Width, w.SharedWidth);
+        w.SharedWidth = 9;
+        REQUIRE(w.Width == 9);
+        w.Width       = 11;
+        REQUIRE(w.SharedWidth == 11);
+        REQUIRE(binding->active());
+        binding->disconnect();
+        REQUIRE_FALSE(binding->active());
+        REQUIRE(w.Width.Changed.slot_count() == 0);
+        }
+    SECTION("In a loop of single-threaded properties") {
+        auto binding = bind_two_way(w.Width, w.Height);
+        w.Height = -3;
+        REQUIRE(w.Height == 0);
+        REQUIRE(w.Width == 0);
+        w.Width  = 4;
+        REQUIRE(w.Height == 4);
+        }
+    }
@@ -0,0 +1,114 @@
+#include "memprop/timeseries.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <thread>
+using namespace mousebyte::memprop;
+using namespace std::chrono_literals;
+
+namespace {
+    class gauge {
+    public:
+        public_property<gauge, double> Load {this, 0.0};
+        public_property<gauge, float, nullptr, single_threaded> Level {this, 0.0f};
+    };
+    }
+
+
+TEST_CASE("A timeseries keeps the most recent samples") {
+    timeseries<int>              series(4);
+    timeseries<int>::time_point  t0 {};
+    std::vector<sample<int>>     out;
+
+    series.snapshot(out);
+    REQUIRE(out.empty());
+
+    for (int i = 0; i < 6; ++i) series.record(i, t0 + i * 1s);
+    REQUIRE(series.size() == 4);
+    series.snapshot(out);
+    REQUIRE(out.size() == 4);
+    REQUIRE(out.front().value == 2);
+    REQUIRE(out.back().value == 5);
+    REQUIRE(out.back().time == t0 + 5s);
+
+    series.snapshot(out, t0 + 4s);
+    REQUIRE(out.size() == 2);
+    REQUIRE(out.front().value == 4);
+    }
+
+TEST_CASE("A timeseries records the changes of a tracked property") {
+    timeseries<double>          series(8);
+    gauge                       g;
+    std::vector<sample<double>> out;
+
+    series.track(g.Load);
+    g.Load = 0.25;
+    g.Load = 0.75;
+    series.untrack();
+    g.Load = 1.0;
+    series.snapshot(out);
+    REQUIRE(out.size() == 2);
+    REQUIRE(out[1].value == 0.75);
+    }
+
+TEST_CASE("Samples can be downsampled into buckets") {
+    timeseries<int>                 series(100);
+    timeseries<int>::time_point     t0 {};
+    std::vector<sample<int>>        out;
+    std::vector<sample_bucket<int>> buckets;
+
+    for (int i = 0; i < 100; ++i) series.record(i % 10, t0 + i * 10ms);
+    series.snapshot(out);
+    downsample<int>(out, 10, buckets);
+    REQUIRE(buckets.size() == 10);
+    for (auto& b : buckets) {
+        REQUIRE(b.count == 10);
+        REQUIRE(b.min == 0);
+        REQUIRE(b.max == 9);
+        REQUIRE(b.mean == 4.5);
+        }
+    }
+
+TEST_CASE("Timeseries snapshots can be taken while recording") {
+    timeseries<std::int64_t> series(64);
+    std::atomic<bool>        done = false;
+    std::thread              writer([&]
+        {
+        for (std::int64_t i = 0; i < 100000; ++i) {
+            series.record(i, timeseries<std::int64_t>::time_point(std::chrono::nanoseconds(i)));
+            }
+        done = true;
+        });
+    std::vector<sample<std::int64_t>> out;
+    auto                              ordered = true;
+
+    while (!done) {
+        series.snapshot(out);
+        for (std::size_t i = 1; i < out.size(); ++i) {
+            ordered = ordered && out[i].value == out[i - 1].value + 1
+                      && out[i].time.time_since_epoch().count() == out[i].value;
+            }
+        }
+    writer.join();
+    REQUIRE(ordered);
+    }
+
+TEST_CASE("A timeseries tracks single-threaded properties") {
+    std::vector<sample<float>> out;
+    gauge                      g;
+    {
+    timeseries<float> series(8);
+
+    series.track(g.Level);
+    g.Level = 0.5f;
+    series.track(g.Load);
+    g.Level = 0.75f;
+    g.Load  = 1.0;
+    series.snapshot(out);
+    REQUIRE(out.size() == 2);
+    REQUIRE(out[0].value == 0.5f);
+    REQUIRE(out[1].value == 1.0f);
+    series.track(g.Level);
+    }
+
+    // destroying the timeseries disconnects it
+    g.Level = 1.0f;
+    }
@@ -0,0 +1,171 @@
+#include "memprop/vetoable.hpp"
+#include "memprop/history.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <string>
+#include <vector>
+using namespace mousebyte::memprop;
+
+namespace {
+    // counts the copies made of it, so tests can tell moves from copies
+    struct tracked_value {
+        static inline int copies = 0;
+
+        std::string text;
+
+        tracked_value() = default;
+
+        tracked_value(
+            char const* t
+            )
+            : text(t)
+            {}
+
+        tracked_value(
+            tracked_value const& other
+            )
+            : text(other.text)
+            {
+            ++copies;
+            }
+
+        tracked_value(tracked_value&&) noexcept = default;
+
+        tracked_value& operator=(
+            tracked_value const& other
+            )
+            {
+            ++copies;
+            text = other.text;
+            return *this;
+            }
+
+        tracked_value& operator=(tracked_value&&) noexcept = default;
+    };
+
+
+    class document {
+    public:
+        vetoable_property<document, tracked_value> Title {this, "untitled"};
+        vetoable_property<document, int, single_threaded> Pages {this, 1};
+    };
+
+
+    class tracked_document
+        : public history_tracking {
+    public:
+        vetoable_property<tracked_document, int, single_threaded> Pages {this, 1};
+    };
+    }
+
+
+TEST_CASE("Vetoable properties report the value they replaced") {
+    document                 d;
+    std::vector<std::string> log;
+
+    d.Title.Replaced.connect([&](tracked_value const& old, tracked_value const& now)
+        {
+        log.push_back(old.text + " -> " + now.text);
+        });
+    d.Title.Changed.connect([&](tracked_value const& now)
+        {
+        log.push_back("changed " + now.text);
+        });
+
+    tracked_value draft = "draft";
+
+    tracked_value::copies = 0;
+    d.Title = draft;
+    REQUIRE(tracked_value::copies == 1);
+    REQUIRE(log == std::vector<std::string> {"untitled -> draft", "changed draft"});
+
+    // assigning a property its own value leaves it intact
+    log.clear();
+    d.Title = static_cast<tracked_value const&>(d.Title);
+    REQUIRE(log == std::vector<std::string> {"draft -> draft", "changed draft"});
+    }
+
+TEST_CASE("Changing slots can veto a change") {
+    document d;
+    auto     replaced = 0;
+    auto     changed  = 0;
+
+    d.Pages.Changing.connect([](int const& current, int const& proposed, change_veto& veto)
+        {
+        if (proposed < current) veto.cancel();
+        });
+    d.Pages.Replaced.connect([&](int const&, int const&)
+        {
+        ++replaced;
+        });
+    d.Pages.Changed.connect([&](int const&)
+        {
+        ++changed;
+        });
+
+    d.Pages = 5;
+    d.Pages = 2;
+    REQUIRE(d.Pages == 5);
+    REQUIRE(replaced == 1);
+    REQUIRE(changed == 1);
+
+    SECTION("Vetoes apply to bound properties") {
+        document other;
+        auto     binding = d.Pages.bind(other.Pages);
+
+        REQUIRE(d.Pages == 5);
+        other.Pages = 8;
+        REQUIRE(d.Pages == 8);
+        }
+    }
+
+TEST_CASE("Replayed values are not announced or vetoed") {
+    property_history history(4096);
+    tracked_document d;
+    auto             changing = 0;
+    auto             replaced = 0;
+    auto             changed  = 0;
+
+    d.record_history(&history);
+    d.Pages.Changing.connect([&](int const& current, int const& proposed, change_veto& veto)
+        {
+        ++changing;
+        if (proposed < current) veto.cancel();
+        });
+    d.Pages.Replaced.connect([&](int const&, int const&)
+        {
+        ++replaced;
+        });
+    d.Pages.Changed.connect([&](int const&)
+        {
+        ++changed;
+        });
+    d.Pages = 5;
+    REQUIRE(changing == 1);
+    REQUIRE(replaced == 1);
+
+    SECTION("Undo and redo") {
+        REQUIRE(history.undo());
+        REQUIRE(d.Pages == 1);
+        REQUIRE(history.redo());
+        REQUIRE(d.Pages == 5);
+        REQUIRE(changing == 1);
+        REQUIRE(replaced == 1);
+        REQUIRE(changed == 3);
+        }
+    SECTION("Silent sets") {
+        REQUIRE(detail::property_access::set_silent(d.Pages, 2));
+        REQUIRE(d.Pages == 2);
+        REQUIRE(changing == 1);
+        REQUIRE(replaced == 1);
+        REQUIRE(changed == 1);
+        }
+    SECTION("Sets made by slots of a replay") {
+        d.Pages.Changed.connect([&](int const& v)
+            {
+            if (v == 1) d.Pages = 0;
+            });
+        REQUIRE(history.undo());
+        REQUIRE(d.Pages == 1);
+        REQUIRE(changing == 2);
+        }
+    }